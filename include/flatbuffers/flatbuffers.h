@@ -26,6 +26,16 @@
 #include <type_traits>
 #include <vector>
 #include <algorithm>
+#include <iterator>
+#include <limits>
+
+#if defined(__has_include)
+  #if __has_include(<string_view>) && \
+      (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+    #include <string_view>
+    #define FLATBUFFERS_HAS_STRING_VIEW 1
+  #endif
+#endif
 
 #if __cplusplus <= 199711L && \
     (!defined(_MSC_VER) || _MSC_VER < 1600) && \
@@ -68,6 +78,12 @@
   #define FLATBUFFERS_FINAL_CLASS
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+  #define FLATBUFFERS_PREFETCH(P) __builtin_prefetch(P)
+#else
+  #define FLATBUFFERS_PREFETCH(P)
+#endif
+
 namespace flatbuffers {
 
 // Our default offset / size type, 32bit on purpose on 64bit systems.
@@ -182,21 +198,22 @@ template<typename T> struct IndirectHelper<const T *> {
   }
 };
 
-// An STL compatible iterator implementation for Vector below, effectively
-// calling Get() for every element.
+// An STL compatible random access iterator implementation for Vector below,
+// effectively calling Get() for every element. Elements are returned by
+// value, so like for std::vector<bool> the reference type isn't a real
+// reference, which all the standard algorithms are fine with.
 template<typename T, bool bConst>
-struct VectorIterator : public
-  std::iterator < std::input_iterator_tag,
-  typename std::conditional < bConst,
-  const typename IndirectHelper<T>::return_type,
-  typename IndirectHelper<T>::return_type > ::type, uoffset_t > {
-
-  typedef std::iterator<std::input_iterator_tag,
-    typename std::conditional<bConst,
+struct VectorIterator {
+  typedef std::random_access_iterator_tag iterator_category;
+  typedef typename std::conditional<bConst,
     const typename IndirectHelper<T>::return_type,
-    typename IndirectHelper<T>::return_type>::type, uoffset_t> super_type;
+    typename IndirectHelper<T>::return_type>::type value_type;
+  typedef ptrdiff_t difference_type;
+  typedef value_type pointer;
+  typedef value_type reference;
 
 public:
+  VectorIterator() : data_(nullptr) {}
   VectorIterator(const uint8_t *data, uoffset_t i) :
       data_(data + IndirectHelper<T>::element_stride * i) {};
   VectorIterator(const VectorIterator &other) : data_(other.data_) {}
@@ -220,30 +237,91 @@ public:
     return data_ != other.data_;
   }
 
-  ptrdiff_t operator-(const VectorIterator& other) const {
-    return (data_ - other.data_) / IndirectHelper<T>::element_stride;
+  bool operator<(const VectorIterator& other) const {
+    return data_ < other.data_;
+  }
+
+  bool operator>(const VectorIterator& other) const {
+    return data_ > other.data_;
+  }
+
+  bool operator<=(const VectorIterator& other) const {
+    return data_ <= other.data_;
+  }
+
+  bool operator>=(const VectorIterator& other) const {
+    return data_ >= other.data_;
+  }
+
+  difference_type operator-(const VectorIterator& other) const {
+    return (data_ - other.data_) /
+           static_cast<difference_type>(IndirectHelper<T>::element_stride);
   }
 
-  typename super_type::value_type operator *() const {
+  value_type operator *() const {
     return IndirectHelper<T>::Read(data_, 0);
   }
 
-  typename super_type::value_type operator->() const {
+  value_type operator->() const {
     return IndirectHelper<T>::Read(data_, 0);
   }
 
+  value_type operator[](difference_type n) const {
+    return IndirectHelper<T>::Read(data_ + Stride(n), 0);
+  }
+
   VectorIterator &operator++() {
     data_ += IndirectHelper<T>::element_stride;
     return *this;
   }
 
   VectorIterator operator++(int) {
-    VectorIterator temp(data_);
+    VectorIterator temp(*this);
     data_ += IndirectHelper<T>::element_stride;
     return temp;
   }
 
+  VectorIterator &operator--() {
+    data_ -= IndirectHelper<T>::element_stride;
+    return *this;
+  }
+
+  VectorIterator operator--(int) {
+    VectorIterator temp(*this);
+    data_ -= IndirectHelper<T>::element_stride;
+    return temp;
+  }
+
+  VectorIterator &operator+=(difference_type n) {
+    data_ += Stride(n);
+    return *this;
+  }
+
+  VectorIterator &operator-=(difference_type n) {
+    data_ -= Stride(n);
+    return *this;
+  }
+
+  VectorIterator operator+(difference_type n) const {
+    VectorIterator temp(*this);
+    return temp += n;
+  }
+
+  friend VectorIterator operator+(difference_type n,
+                                  const VectorIterator &it) {
+    return it + n;
+  }
+
+  VectorIterator operator-(difference_type n) const {
+    VectorIterator temp(*this);
+    return temp -= n;
+  }
+
 private:
+  static difference_type Stride(difference_type n) {
+    return n * static_cast<difference_type>(IndirectHelper<T>::element_stride);
+  }
+
   const uint8_t *data_;
 };
 
@@ -273,6 +351,26 @@ public:
     return static_cast<E>(Get(i));
   }
 
+  // For a vector of tables sorted by their key field (see the key attribute
+  // and FlatBufferBuilder::CreateVectorOfSortedTables()), find the table
+  // with the given key using binary search. Returns nullptr if not found.
+  template<typename K> return_type LookupByKey(K key) const {
+    uoffset_t lo = 0, hi = size();
+    while (lo < hi) {
+      auto mid = lo + (hi - lo) / 2;
+      auto element = Get(mid);
+      auto cmp = element->KeyCompareWithValue(key);
+      if (cmp < 0) {
+        lo = mid + 1;
+      } else if (cmp > 0) {
+        hi = mid;
+      } else {
+        return element;
+      }
+    }
+    return nullptr;
+  }
+
   const void *GetStructFromOffset(size_t o) const {
     return reinterpret_cast<const void *>(Data() + o);
   }
@@ -312,17 +410,181 @@ template<typename T> static inline size_t VectorLength(const Vector<T> *v) {
   return v ? v->Length() : 0;
 }
 
+// A non-owning reference to a string, e.g. inside a buffer.
+#ifdef FLATBUFFERS_HAS_STRING_VIEW
+  typedef std::string_view string_view;
+#else
+  // The subset of C++17's std::string_view that we need, when it isn't
+  // available.
+  class string_view {
+   public:
+    string_view() : data_(nullptr), size_(0) {}
+    string_view(const char *str) : data_(str), size_(strlen(str)) {}
+    string_view(const char *str, size_t size) : data_(str), size_(size) {}
+    string_view(const std::string &str)
+      : data_(str.data()), size_(str.size()) {}
+
+    const char *data() const { return data_; }
+    size_t size() const { return size_; }
+    size_t length() const { return size_; }
+    bool empty() const { return !size_; }
+    const char *begin() const { return data_; }
+    const char *end() const { return data_ + size_; }
+    char operator[](size_t i) const { return data_[i]; }
+
+    int compare(string_view o) const {
+      // A default constructed view has no data, which memcmp mustn't see.
+      auto len = (std::min)(size_, o.size_);
+      auto cmp = len ? memcmp(data_, o.data_, len) : 0;
+      return cmp ? cmp
+                 : static_cast<int>(size_ > o.size_) -
+                   static_cast<int>(size_ < o.size_);
+    }
+
+    explicit operator std::string() const {
+      return std::string(data_, size_);
+    }
+
+   private:
+    const char *data_;
+    size_t size_;
+  };
+
+  inline bool operator==(string_view a, string_view b) {
+    return a.size() == b.size() &&
+           (!a.size() || !memcmp(a.data(), b.data(), a.size()));
+  }
+  inline bool operator!=(string_view a, string_view b) { return !(a == b); }
+  inline bool operator<(string_view a, string_view b) {
+    return a.compare(b) < 0;
+  }
+#endif
+
+// Strings are compared by their bytes and length (like std::string), so they
+// may contain 0 bytes.
 struct String : public Vector<char> {
   const char *c_str() const { return reinterpret_cast<const char *>(Data()); }
   std::string str() const { return std::string(c_str(), Length()); }
   void append_to(std::string& target) const { target.append(c_str(), Length()); }
   void assign_to(std::string& target) const { target.assign(c_str(), Length()); }
 
-  bool operator <(const String &o) const {
-    return strcmp(c_str(), o.c_str()) < 0;
+  // Access without making a copy.
+  string_view str_view() const { return string_view(c_str(), Length()); }
+
+  // Returns <0, 0 or >0 like strcmp.
+  int compare(string_view o) const { return str_view().compare(o); }
+
+  bool operator <(const String &o) const { return compare(o.str_view()) < 0; }
+  bool operator ==(const String &o) const {
+    return str_view() == o.str_view();
   }
+  bool operator !=(const String &o) const { return !(*this == o); }
 };
 
+// Hashes of keys, as stored in hash indices (see the hash_index attribute):
+// 32 bit FNV-1a over the bytes of the key, little endian for scalars.
+// Changing these would break existing buffers.
+inline uint32_t HashBytes(const uint8_t *bytes, size_t len) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+inline uint32_t HashString(const char *str) {
+  return HashBytes(reinterpret_cast<const uint8_t *>(str), strlen(str));
+}
+
+// Whether the "len" bytes at "s" are valid UTF-8: no overlong encodings,
+// surrogates or code points past U+10FFFF. ASCII is skipped 8 bytes at a
+// time.
+inline bool IsValidUTF8(const uint8_t *s, size_t len) {
+  auto end = s + len;
+  while (s < end) {
+    if (end - s >= 8) {
+      uint64_t word;
+      memcpy(&word, s, sizeof(word));
+      if (!(word & 0x8080808080808080ULL)) {
+        s += 8;
+        continue;
+      }
+    }
+    auto c = *s;
+    if (c < 0x80) {
+      s++;
+      continue;
+    }
+    // The number of continuation bytes, and the range the first one must be
+    // in to rule out overlong encodings, surrogates and too large values.
+    int n;
+    uint8_t lo = 0x80, hi = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF) {
+      n = 1;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+      n = 2;
+      if (c == 0xE0) lo = 0xA0;
+      if (c == 0xED) hi = 0x9F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+      n = 3;
+      if (c == 0xF0) lo = 0x90;
+      if (c == 0xF4) hi = 0x8F;
+    } else {
+      return false;
+    }
+    if (end - s <= n || s[1] < lo || s[1] > hi) return false;
+    for (int i = 2; i <= n; i++) {
+      if ((s[i] & 0xC0) != 0x80) return false;
+    }
+    s += n + 1;
+  }
+  return true;
+}
+
+inline uint32_t HashString(const String *str) {
+  return str ? HashBytes(str->Data(), str->size()) : HashBytes(nullptr, 0);
+}
+
+inline uint32_t HashString(string_view str) {
+  return HashBytes(reinterpret_cast<const uint8_t *>(str.data()), str.size());
+}
+
+// Hash functor for strings in a buffer, for use with e.g. unordered_map.
+struct StringHash {
+  size_t operator()(const String *str) const { return HashString(str); }
+  size_t operator()(string_view str) const { return HashString(str); }
+};
+
+template<typename T> uint32_t HashScalar(T key) {
+  auto little_endian_key = EndianScalar(key);
+  return HashBytes(reinterpret_cast<const uint8_t *>(&little_endian_key),
+                   sizeof(T));
+}
+
+// Find the table with the given key in a vector of tables with a key field,
+// using the hash index that goes with it (see the hash_index attribute).
+// Without an index, this falls back to binary search, which requires the
+// vector to be sorted. Returns nullptr if not found.
+template<typename T, typename K> const T *LookupByHashIndex(
+                                          const Vector<Offset<T>> *vec,
+                                          const Vector<uint32_t> *index,
+                                          K key) {
+  if (!vec) return nullptr;
+  if (!index || !index->size()) return vec->LookupByKey(key);
+  auto mask = index->size() - 1;
+  auto slot = T::KeyHash(key) & mask;
+  // Each slot holds an element index + 1, or 0 if empty.
+  for (uoffset_t probes = 0; probes < index->size(); probes++) {
+    auto element = index->Get(slot);
+    if (!element) break;
+    auto table = vec->Get(element - 1);
+    if (!table->KeyCompareWithValue(key)) return table;
+    slot = (slot + 1) & mask;
+  }
+  return nullptr;
+}
+
 // Simple indirection for buffer allocation, to allow this to be overridden
 // with custom allocation (see the FlatBufferBuilder constructor).
 class simple_allocator {
@@ -330,40 +592,225 @@ class simple_allocator {
   virtual ~simple_allocator() {}
   virtual uint8_t *allocate(size_t size) const { return new uint8_t[size]; }
   virtual void deallocate(uint8_t *p) const { delete[] p; }
+
+  // Grow block "p" from old_size to new_size bytes. The in_use bytes at the
+  // top of the old block must end up at the top of the returned block
+  // (vector_downward fills blocks from the top down). Override this if the
+  // allocator can do that without copying.
+  virtual uint8_t *reallocate_downward(uint8_t *p, size_t old_size,
+                                       size_t new_size, size_t in_use) const {
+    auto new_p = allocate(new_size);
+    memcpy(new_p + new_size - in_use, p + old_size - in_use, in_use);
+    deallocate(p);
+    return new_p;
+  }
+};
+
+// Decides how many bytes to add when a builder's buffer of "reserved" bytes
+// is full. The result is rounded down to the scalar alignment, and is never
+// used if less than what's needed for the write that triggered the growth.
+typedef size_t (*growth_policy_t)(size_t reserved);
+
+// The default: grow by half the current size.
+inline size_t GrowByHalf(size_t reserved) { return reserved / 2; }
+
+// The allocator used when none is given, shared by all builders so memory
+// it allocated can outlive the builder (see FlatBufferBuilder::Release()).
+inline const simple_allocator &default_allocator() {
+  static simple_allocator allocator;
+  return allocator;
+}
+
+// A finished buffer that was released from its builder, and owns the memory
+// block it lives in. The data is located somewhere inside that block, since
+// builders fill it from the top down.
+// It's move-only, and frees the block with the allocator that allocated it,
+// which therefore has to outlive it.
+class DetachedBuffer {
+ public:
+  DetachedBuffer()
+    : allocator_(nullptr), buf_(nullptr), data_(nullptr), size_(0) {}
+
+  DetachedBuffer(const simple_allocator *allocator, uint8_t *buf,
+                 uint8_t *data, size_t size)
+    : allocator_(allocator), buf_(buf), data_(data), size_(size) {}
+
+  DetachedBuffer(DetachedBuffer &&other)
+    : allocator_(other.allocator_), buf_(other.buf_), data_(other.data_),
+      size_(other.size_) {
+    other.reset();
+  }
+
+  DetachedBuffer &operator=(DetachedBuffer &&other) {
+    if (this != &other) {
+      destroy();
+      allocator_ = other.allocator_;
+      buf_ = other.buf_;
+      data_ = other.data_;
+      size_ = other.size_;
+      other.reset();
+    }
+    return *this;
+  }
+
+  ~DetachedBuffer() { destroy(); }
+
+  const uint8_t *data() const { return data_; }
+  uint8_t *data() { return data_; }
+  size_t size() const { return size_; }
+
+  // The memory block holding the data, and the allocator that must free it.
+  uint8_t *block() const { return buf_; }
+  const simple_allocator *allocator() const { return allocator_; }
+
+  // Give up ownership of the block without freeing it. The caller then has
+  // to free block() with allocator() itself.
+  uint8_t *release() {
+    auto buf = buf_;
+    reset();
+    return buf;
+  }
+
+ private:
+  // You can't copy these, only move them.
+  DetachedBuffer(const DetachedBuffer &);
+  DetachedBuffer &operator=(const DetachedBuffer &);
+
+  void destroy() { if (buf_) allocator_->deallocate(buf_); reset(); }
+
+  void reset() {
+    allocator_ = nullptr;
+    buf_ = data_ = nullptr;
+    size_ = 0;
+  }
+
+  const simple_allocator *allocator_;
+  uint8_t *buf_;
+  uint8_t *data_;
+  size_t size_;
+};
+
+// One contiguous piece of a finished buffer, in the same spirit as POSIX
+// struct iovec (see FlatBufferBuilder::GetBufferSegments()).
+struct BufferSegment {
+  const uint8_t *data;
+  size_t size;
 };
 
 // This is a minimal replication of std::vector<uint8_t> functionality,
 // except growing from higher to lower addresses. i.e push_back() inserts data
 // in the lowest address in the vector.
+// Optionally, it stores its data in a list of separately allocated chunks
+// instead (see set_chunk_size()), and it can refer to data elsewhere in
+// memory rather than copying it (see push_external()).
 class vector_downward {
  public:
   explicit vector_downward(size_t initial_size,
                            const simple_allocator &allocator)
-    : reserved_(initial_size),
+    : initial_size_(initial_size),
+      reserved_(initial_size),
       buf_(allocator.allocate(reserved_)),
       cur_(buf_ + reserved_),
-      allocator_(allocator) {
+      allocator_(allocator),
+      growth_policy_(GrowByHalf),
+      chunk_size_(0),
+      full_size_(0),
+      num_reallocations_(0) {
     assert((initial_size & (sizeof(largest_scalar_t) - 1)) == 0);
   }
 
-  ~vector_downward() { allocator_.deallocate(buf_); }
+  ~vector_downward() {
+    free_full_chunks();
+    if (buf_) allocator_.deallocate(buf_);
+  }
+
+  void clear() {
+    free_full_chunks();
+    cur_ = buf_ + reserved_;
+  }
+
+  // Hand the memory block over to the caller, who becomes responsible for
+  // freeing it with get_allocator(). Data spread over several blocks is
+  // copied into one first. Leaves this vector empty, and a new block will be
+  // allocated on the next write.
+  uint8_t *release() {
+    flatten(true);
+    auto buf = buf_;
+    buf_ = cur_ = nullptr;
+    reserved_ = 0;
+    return buf;
+  }
 
-  void clear() { cur_ = buf_ + reserved_; }
+  const simple_allocator &get_allocator() const { return allocator_; }
+
+  // Make sure at least "len" bytes fit without growing (nothing to do when
+  // using chunks, those never grow).
+  void reserve(size_t len) {
+    len = align(len);
+    if (chunk_size_ || len <= reserved_) return;
+    if (!buf_) {
+      set_initial_size(len);
+      return;
+    }
+    auto used = block_size();
+    buf_ = allocator_.reallocate_downward(buf_, reserved_, len, used);
+    reserved_ = len;
+    cur_ = buf_ + reserved_ - used;
+  }
+
+  // The size of the next block allocated after release().
+  void set_initial_size(size_t initial_size) {
+    initial_size_ = align(initial_size);
+  }
+
+  // How often the buffer had to grow (or start a new chunk) while being
+  // written to, over the lifetime of this vector.
+  size_t num_reallocations() const { return num_reallocations_; }
+
+  void set_growth_policy(growth_policy_t policy) { growth_policy_ = policy; }
 
   size_t growth_policy(size_t bytes) {
-    return (bytes / 2) & ~(sizeof(largest_scalar_t) - 1);
+    return growth_policy_(bytes) & ~(sizeof(largest_scalar_t) - 1);
+  }
+
+  // Rather than growing one block (and moving the data every time), store
+  // data in blocks of (at least) chunk_size bytes, starting a new one when
+  // the current one is full. Chunks are filled up completely, so the data
+  // is the same as if it were contiguous, except for some padding between
+  // objects. Anything that must be contiguous has to be reserved up front
+  // with ensure_contiguous(). 0 returns to a single block.
+  // Can only be changed while empty.
+  void set_chunk_size(size_t chunk_size) {
+    assert(!size());
+    assert((chunk_size & (sizeof(largest_scalar_t) - 1)) == 0);
+    if (buf_) allocator_.deallocate(buf_);
+    buf_ = cur_ = nullptr;
+    reserved_ = 0;
+    chunk_size_ = chunk_size;
+  }
+
+  // Make sure the next "len" bytes written end up adjacent in memory.
+  void ensure_contiguous(size_t len) {
+    if (chunk_size_ && len > static_cast<size_t>(cur_ - buf_)) new_chunk(len);
   }
 
   uint8_t *make_space(size_t len) {
-    if (buf_ > cur_ - len) {
-      auto old_size = size();
-      reserved_ += std::max(len, growth_policy(reserved_));
-      auto new_buf = allocator_.allocate(reserved_);
-      auto new_cur = new_buf + reserved_ - old_size;
-      memcpy(new_cur, cur_, old_size);
-      cur_ = new_cur;
-      allocator_.deallocate(buf_);
-      buf_ = new_buf;
+    if (len > static_cast<size_t>(cur_ - buf_)) {
+      if (chunk_size_) {
+        new_chunk(len);
+      } else {
+        auto used = block_size();
+        auto old_reserved = reserved_;
+        if (buf_) num_reallocations_++;
+        // Keep the size aligned, so the top of the block stays aligned.
+        reserved_ += std::max(align(len), buf_ ? growth_policy(reserved_)
+                                                : initial_size_);
+        buf_ = buf_
+          ? allocator_.reallocate_downward(buf_, old_reserved, reserved_,
+                                           used)
+          : allocator_.allocate(reserved_);
+        cur_ = buf_ + reserved_ - used;
+      }
     }
     cur_ -= len;
     // Beyond this, signed offsets may not have enough range:
@@ -373,36 +820,175 @@ class vector_downward {
   }
 
   uoffset_t size() const {
-    return static_cast<uoffset_t>(reserved_ - (cur_ - buf_));
+    return static_cast<uoffset_t>(full_size_ + block_size());
+  }
+
+  // Insert "len" bytes that live elsewhere without copying them. They must
+  // stay valid as long as this vector refers to them, and size() + len must
+  // be a multiple of sizeof(largest_scalar_t), so data written after them
+  // stays aligned. The bytes can't be accessed through data() or data_at(),
+  // they're only in segments() (or copied in by flatten()).
+  void push_external(const uint8_t *bytes, size_t len) {
+    assert(((size() + len) & (sizeof(largest_scalar_t) - 1)) == 0);
+    if (!len) return;
+    if (buf_) {
+      // Anything after this goes into a new block.
+      Chunk chunk = { buf_, reserved_, cur_, block_size(), full_size_ };
+      full_chunks_.push_back(chunk);
+      full_size_ += chunk.size;
+    }
+    Chunk external = { nullptr, 0, bytes, len, full_size_ };
+    full_chunks_.push_back(external);
+    full_size_ += len;
+    buf_ = cur_ = nullptr;
+    reserved_ = 0;
+  }
+
+  bool has_external() const {
+    for (auto it = full_chunks_.begin(); it != full_chunks_.end(); ++it) {
+      if (!it->block) return true;
+    }
+    return false;
+  }
+
+  // Make sure all the data is in a single block, copying it if it's spread
+  // over several blocks or refers to external data, and return its start.
+  // When using chunks, this does nothing unless "join_chunks" is set, since
+  // data written after it would start a new chunk anyway.
+  uint8_t *flatten(bool join_chunks = false) {
+    if ((chunk_size_ && !join_chunks) || full_chunks_.empty()) return cur_;
+    auto len = size();
+    auto reserved = align(len);
+    auto block = allocator_.allocate(reserved);
+    auto dest = block + reserved - len;
+    auto segs = segments();
+    for (auto it = segs.begin(); it != segs.end(); ++it) {
+      memcpy(dest, it->data, it->size);
+      dest += it->size;
+    }
+    free_full_chunks();
+    if (buf_) allocator_.deallocate(buf_);
+    buf_ = block;
+    reserved_ = reserved;
+    cur_ = buf_ + reserved_ - len;
+    return cur_;
   }
 
+  // The start of the data. When using chunks, only the data in the current
+  // chunk is adjacent to it.
   uint8_t *data() const { return cur_; }
 
-  uint8_t *data_at(size_t offset) { return buf_ + reserved_ - offset; }
+  uint8_t *data_at(size_t offset) {
+    if (offset > full_size_ || full_chunks_.empty())
+      return buf_ + reserved_ - (offset - full_size_);
+    // Find the chunk that holds the byte "offset" bytes from the end.
+    auto chunk = std::lower_bound(full_chunks_.begin(), full_chunks_.end(),
+                                  offset, [](const Chunk &c, size_t o) {
+      return c.base + c.size < o;
+    });
+    assert(chunk->block);  // Not external data.
+    return chunk->block + chunk->reserved - (offset - chunk->base);
+  }
+
+  // All the data, from the start to the end.
+  std::vector<BufferSegment> segments() const {
+    std::vector<BufferSegment> segs;
+    segs.reserve(full_chunks_.size() + 1);
+    if (buf_ + reserved_ != cur_) {
+      BufferSegment seg = { cur_,
+                            static_cast<size_t>(buf_ + reserved_ - cur_) };
+      segs.push_back(seg);
+    }
+    for (auto it = full_chunks_.rbegin(); it != full_chunks_.rend(); ++it) {
+      BufferSegment seg = { it->data, it->size };
+      segs.push_back(seg);
+    }
+    return segs;
+  }
 
-  // push() & fill() are most frequently called with small byte counts (<= 4),
-  // which is why we're using loops rather than calling memcpy/memset.
   void push(const uint8_t *bytes, size_t num) {
-    auto dest = make_space(num);
-    for (size_t i = 0; i < num; i++) dest[i] = bytes[i];
+    memcpy(make_space(num), bytes, num);
   }
 
   void fill(size_t zero_pad_bytes) {
-    auto dest = make_space(zero_pad_bytes);
-    for (size_t i = 0; i < zero_pad_bytes; i++) dest[i] = 0;
+    memset(make_space(zero_pad_bytes), 0, zero_pad_bytes);
+  }
+
+  void pop(size_t bytes_to_remove) {
+    // Popping past the start of the current chunk brings back the previous
+    // one.
+    while (bytes_to_remove > block_size()) {
+      bytes_to_remove -= block_size();
+      if (buf_) allocator_.deallocate(buf_);
+      auto &chunk = full_chunks_.back();
+      assert(chunk.block);  // Can't pop external data.
+      buf_ = chunk.block;
+      reserved_ = chunk.reserved;
+      cur_ = buf_ + reserved_ - chunk.size;
+      full_size_ = chunk.base;
+      full_chunks_.pop_back();
+    }
+    cur_ += bytes_to_remove;
   }
 
-  void pop(size_t bytes_to_remove) { cur_ += bytes_to_remove; }
-
  private:
   // You shouldn't really be copying instances of this class.
   vector_downward(const vector_downward &);
   vector_downward &operator=(const vector_downward &);
 
+  // A block that is no longer written to, holding "size" bytes of data at
+  // the top. External data has no block. base is the amount of data that
+  // comes after it, i.e. in older chunks.
+  struct Chunk {
+    uint8_t *block;
+    size_t reserved;
+    const uint8_t *data;
+    size_t size;
+    size_t base;
+  };
+
+  // The amount of data in the current block.
+  size_t block_size() const {
+    return static_cast<size_t>(buf_ + reserved_ - cur_);
+  }
+
+  static size_t align(size_t len) {
+    return (len + sizeof(largest_scalar_t) - 1) &
+           ~(sizeof(largest_scalar_t) - 1);
+  }
+
+  void new_chunk(size_t len) {
+    if (buf_) {
+      num_reallocations_++;
+      // Pad out the rest of this chunk, it is part of the buffer now.
+      memset(buf_, 0, cur_ - buf_);
+      Chunk chunk = { buf_, reserved_, buf_, reserved_, full_size_ };
+      full_chunks_.push_back(chunk);
+      full_size_ += reserved_;
+    }
+    reserved_ = std::max(chunk_size_, align(len));
+    buf_ = allocator_.allocate(reserved_);
+    cur_ = buf_ + reserved_;
+  }
+
+  void free_full_chunks() {
+    for (auto it = full_chunks_.begin(); it != full_chunks_.end(); ++it) {
+      if (it->block) allocator_.deallocate(it->block);
+    }
+    full_chunks_.clear();
+    full_size_ = 0;
+  }
+
+  size_t initial_size_;
   size_t reserved_;
   uint8_t *buf_;
   uint8_t *cur_;  // Points at location between empty (below) and used (above).
   const simple_allocator &allocator_;
+  growth_policy_t growth_policy_;
+  size_t chunk_size_;
+  std::vector<Chunk> full_chunks_;  // Oldest first.
+  size_t full_size_;  // Sum of the sizes of full_chunks_.
+  size_t num_reallocations_;
 };
 
 // Converts a Field ID to a virtual table offset.
@@ -429,10 +1015,12 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
  public:
   explicit FlatBufferBuilder(uoffset_t initial_size = 1024,
                              const simple_allocator *allocator = nullptr)
-      : buf_(initial_size, allocator ? *allocator : default_allocator),
-        minalign_(1), force_defaults_(false) {
+      : buf_(initial_size, allocator ? *allocator : default_allocator()),
+        num_vtables_(0), max_vtables_(~static_cast<size_t>(0)),
+        num_pooled_strings_(0), num_size_hints_(0), next_size_hint_(0),
+        num_clears_(0), minalign_(1), force_defaults_(false), sort_fields_(false) {
     offsetbuf_.reserve(16);  // Avoid first few reallocs.
-    vtables_.reserve(16);
+    vtables_.resize(16);     // Hash index, must be a power of 2.
     EndianCheck();
   }
 
@@ -441,18 +1029,107 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
   void Clear() {
     buf_.clear();
     offsetbuf_.clear();
-    vtables_.clear();
+    staged_fields_.clear();
+    staged_bytes_.clear();
+    std::fill(vtables_.begin(), vtables_.end(), 0);
+    num_vtables_ = 0;
+    std::fill(string_pool_.begin(), string_pool_.end(), 0);
+    num_pooled_strings_ = 0;
     minalign_ = 1;
+    num_clears_++;
+    if (!size_hints_.empty()) {
+      buf_.set_initial_size(*std::max_element(size_hints_.begin(),
+                                              size_hints_.end()));
+    }
   }
 
+  // How often the builder was reset (by Clear() or Release()), so offsets
+  // remembered from an earlier buffer can be recognized, e.g. by the
+  // generated fixed layout builders.
+  size_t GetClearCount() const { return num_clears_; }
+
   // The current size of the serialized buffer, counting from the end.
   uoffset_t GetSize() const { return buf_.size(); }
 
   // Get the serialized buffer (after you call Finish()).
-  uint8_t *GetBufferPointer() const { return buf_.data(); }
+  // If it refers to external data (see CreateExternalVector()), that is
+  // copied in first.
+  uint8_t *GetBufferPointer() { return buf_.flatten(); }
+
+  // Only for a buffer without external data, which can't be copied in here.
+  uint8_t *GetBufferPointer() const {
+    assert(!buf_.has_external());
+    return buf_.data();
+  }
+
+  // Get the serialized buffer (after you call Finish()) as a list of
+  // segments, in order, e.g. to pass to writev(). This is the only way to
+  // get at all of the buffer when using UseChunks().
+  std::vector<BufferSegment> GetBufferSegments() const {
+    return buf_.segments();
+  }
+
+  // Take ownership of the serialized buffer (after you call Finish()),
+  // without copying it. The builder is reset as with Clear(), and allocates
+  // a new buffer when it is used again. With UseChunks() (or external data),
+  // the pieces are copied into one block first.
+  DetachedBuffer Release() {
+    auto size = buf_.size();
+    auto data = buf_.flatten(true);
+    auto buf = buf_.release();
+    Clear();
+    return DetachedBuffer(&buf_.get_allocator(), buf, data, size);
+  }
 
   void ForceDefaults(bool fd) { force_defaults_ = fd; }
 
+  // Rather than writing table fields as they are added, keep them aside and
+  // write them largest first in EndTable(), which minimizes the padding
+  // between them. The generated CreateX() functions already add fields in
+  // that order, this helps when adding them in any other order.
+  void SortFields(bool sort) { sort_fields_ = sort; }
+
+  // Make room for a buffer of at least "size" bytes up front, e.g. based on
+  // the kInlineSizeEstimate of the generated builders, so it doesn't have to
+  // grow while being built.
+  void Reserve(size_t size) { buf_.reserve(size); }
+
+  // Remember the sizes of the last "num_buffers" finished buffers, and size
+  // a newly allocated buffer (after Release()) to fit the largest of them.
+  // 0 turns this off again.
+  void LearnInitialSize(size_t num_buffers) {
+    num_size_hints_ = num_buffers;
+    next_size_hint_ = 0;
+    size_hints_.clear();
+  }
+
+  // How often the buffer had to grow while building, since this builder was
+  // created. Useful to tune Reserve() and the initial size.
+  size_t GetReallocationCount() const { return buf_.num_reallocations(); }
+
+  // Change how the buffer grows when it runs out of space (see
+  // growth_policy_t).
+  void SetGrowthPolicy(growth_policy_t policy) {
+    buf_.set_growth_policy(policy);
+  }
+
+  // Write the buffer into separately allocated chunks of chunk_size bytes
+  // (a multiple of 8) rather than one growing block, for very large buffers.
+  // Objects never straddle chunks, which may leave some padding at the end
+  // of each. The result can only be read with GetBufferSegments(), since
+  // GetBufferPointer() only sees the last chunk.
+  // Call this before building anything; Clear() keeps the setting.
+  void UseChunks(size_t chunk_size) {
+    NotNested();
+    buf_.set_chunk_size(chunk_size);
+  }
+
+  // Limit how many distinct vtables EndTable() remembers for sharing.
+  // Once the limit is reached, new vtable layouts are still written but
+  // not shared with later tables. 0 turns vtable sharing off entirely, which
+  // skips hashing each vtable but makes the buffer larger.
+  void DedupVtables(size_t max_vtables) { max_vtables_ = max_vtables; }
+
   void Pad(size_t num_bytes) { buf_.fill(num_bytes); }
 
   void Align(size_t elem_size) {
@@ -499,17 +1176,31 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
   template<typename T> void AddElement(voffset_t field, T e, T def) {
     // We don't serialize values equal to the default.
     if (e == def && !force_defaults_) return;
+    if (sort_fields_) {
+      auto little_endian_element = EndianScalar(e);
+      StageField(field, &little_endian_element, sizeof(T), sizeof(T), false);
+      return;
+    }
     auto off = PushElement(e);
     TrackField(field, off);
   }
 
   template<typename T> void AddOffset(voffset_t field, Offset<T> off) {
     if (!off.o) return;  // An offset of 0 means NULL, don't store.
+    if (sort_fields_) {
+      // Can only be made relative once we know where it goes.
+      StageField(field, &off.o, sizeof(uoffset_t), sizeof(uoffset_t), true);
+      return;
+    }
     AddElement(field, ReferTo(off.o), static_cast<uoffset_t>(0));
   }
 
   template<typename T> void AddStruct(voffset_t field, const T *structptr) {
     if (!structptr) return;  // Default, don't store.
+    if (sort_fields_) {
+      StageField(field, structptr, sizeof(T), AlignOf<T>(), false);
+      return;
+    }
     Align(AlignOf<T>());
     PushBytes(reinterpret_cast<const uint8_t *>(structptr), sizeof(T));
     TrackField(field, GetSize());
@@ -531,7 +1222,7 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
   void NotNested() {
     // If you hit this, you're trying to construct an object when another
     // hasn't finished yet.
-    assert(!offsetbuf_.size());
+    assert(!offsetbuf_.size() && !staged_fields_.size());
   }
 
   // From generated code (or from the parser), we call StartTable/EndTable
@@ -545,6 +1236,10 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
   // table, comparing it against existing vtables, and writing the
   // resulting vtable offset.
   uoffset_t EndTable(uoffset_t start, voffset_t numfields) {
+    if (!staged_fields_.empty()) WriteStagedFields();
+    // The vtable is written in pieces, but must be contiguous.
+    buf_.ensure_contiguous(sizeof(soffset_t) * 2 +
+                           FieldIndexToOffset(numfields));
     // Write the vtable offset, which is the start of any Table.
     // We fill it's value later.
     auto vtableoffsetloc = PushElement<soffset_t>(0);
@@ -566,22 +1261,19 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
       WriteScalar<voffset_t>(buf_.data() + field_location->id, pos);
     }
     offsetbuf_.clear();
-    auto vt1 = reinterpret_cast<voffset_t *>(buf_.data());
-    auto vt1_size = ReadScalar<voffset_t>(vt1);
     auto vt_use = GetSize();
     // See if we already have generated a vtable with this exact same
     // layout before. If so, make it point to the old one, remove this one.
-    for (auto it = vtables_.begin(); it != vtables_.end(); ++it) {
-      auto vt2 = reinterpret_cast<voffset_t *>(buf_.data_at(*it));
-      auto vt2_size = *vt2;
-      if (vt1_size != vt2_size || memcmp(vt2, vt1, vt1_size)) continue;
-      vt_use = *it;
-      buf_.pop(GetSize() - vtableoffsetloc);
-      break;
-    }
-    // If this is a new vtable, remember it.
-    if (vt_use == GetSize()) {
-      vtables_.push_back(vt_use);
+    if (max_vtables_) {
+      auto slot = FindVtable(buf_.data());
+      if (*slot) {
+        vt_use = *slot;
+        buf_.pop(GetSize() - vtableoffsetloc);
+      } else if (num_vtables_ < max_vtables_) {
+        // This is a new vtable, remember it.
+        *slot = vt_use;
+        if (++num_vtables_ * 2 > vtables_.size()) GrowVtableIndex();
+      }
     }
     // Fill the vtable offset we created above.
     // The offset points from the beginning of the object to where the
@@ -598,13 +1290,48 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
   // just been constructed.
   template<typename T> void Required(Offset<T> table, voffset_t field) {
     auto table_ptr = buf_.data_at(table.o);
-    auto vtable_ptr = table_ptr - ReadScalar<soffset_t>(table_ptr);
+    // Located by offset rather than address, it may be in another chunk.
+    auto vtable_ptr = buf_.data_at(table.o + ReadScalar<soffset_t>(table_ptr));
     bool ok = ReadScalar<voffset_t>(vtable_ptr + field) != 0;
     // If this fails, the caller will show what field needs to be set.
     assert(ok);
     (void)ok;
   }
 
+  // A fast path for tables that always have all their fields, at fixed
+  // places (see the fixed_layout attribute). Their vtable is written only
+  // once per buffer: it holds the offset of each field (0 for deprecated
+  // ones), in a table of "table_size" bytes. Returns where it went.
+  uoffset_t CreateVtable(const voffset_t *field_offsets, voffset_t numfields,
+                         voffset_t table_size) {
+    NotNested();
+    buf_.ensure_contiguous(FieldIndexToOffset(numfields) + 1);
+    for (auto i = numfields; i > 0; ) {
+      PushElement(field_offsets[--i]);
+    }
+    PushElement(table_size);
+    PushElement(FieldIndexToOffset(numfields));
+    return GetSize();
+  }
+
+  // Then each table is written by reserving its "table_size" bytes with
+  // StartFixedTable(), which points it at its vtable, and storing the fields
+  // at their offsets from the address returned. Field alignment is relative
+  // to the start of the table, which is aligned to "alignment".
+  // Afterwards, the table's offset is GetSize().
+  uint8_t *StartFixedTable(uoffset_t vtable, size_t table_size,
+                           size_t alignment) {
+    NotNested();
+    buf_.ensure_contiguous(table_size + alignment);
+    if (alignment > minalign_) minalign_ = alignment;
+    PreAlign(table_size, alignment);
+    auto table = buf_.make_space(table_size);
+    memset(table, 0, table_size);  // Padding between fields.
+    WriteScalar(table, static_cast<soffset_t>(vtable) -
+                       static_cast<soffset_t>(GetSize()));
+    return table;
+  }
+
   uoffset_t StartStruct(size_t alignment) {
     Align(alignment);
     return GetSize();
@@ -614,6 +1341,27 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
 
   void ClearOffsets() { offsetbuf_.clear(); }
 
+  // Scalars are stored with a single copy (byte swapping them on big endian
+  // hosts), offsets need converting one by one.
+  template<typename T> void PushElements(const T *v, size_t len,
+                                         std::true_type) {
+    auto dest = buf_.make_space(len * sizeof(T));
+    #if FLATBUFFERS_LITTLEENDIAN
+      memcpy(dest, v, len * sizeof(T));
+    #else
+      for (size_t i = 0; i < len; i++) {
+        WriteScalar(dest + i * sizeof(T), v[i]);
+      }
+    #endif
+  }
+
+  template<typename T> void PushElements(const T *v, size_t len,
+                                         std::false_type) {
+    for (auto i = len; i > 0; ) {
+      PushElement(v[--i]);
+    }
+  }
+
   // Aligns such that when "len" bytes are written, an object can be written
   // after it with "alignment" without padding.
   void PreAlign(size_t len, size_t alignment) {
@@ -627,6 +1375,7 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
   // Functions to store strings, which are allowed to contain any binary data.
   Offset<String> CreateString(const char *str, size_t len) {
     NotNested();
+    buf_.ensure_contiguous(sizeof(uoffset_t) * 2 + len + 1);
     PreAlign<uoffset_t>(len + 1);  // Always 0-terminated.
     buf_.fill(1);
     PushBytes(reinterpret_cast<const uint8_t *>(str), len);
@@ -642,11 +1391,36 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
     return CreateString(str.c_str(), str.length());
   }
 
+  // Like CreateString, but if a string with identical contents was already
+  // created with CreateSharedString in this buffer, returns the offset of
+  // that one instead of storing another copy.
+  Offset<String> CreateSharedString(const char *str, size_t len) {
+    if (string_pool_.empty()) string_pool_.resize(16);
+    auto slot = FindPooledString(str, len);
+    if (*slot) return Offset<String>(*slot);
+    // Growing the pool frees the slot, so keep the offset.
+    auto off = CreateString(str, len).o;
+    *slot = off;
+    if (++num_pooled_strings_ * 2 > string_pool_.size()) GrowStringPool();
+    return Offset<String>(off);
+  }
+
+  Offset<String> CreateSharedString(const char *str) {
+    return CreateSharedString(str, strlen(str));
+  }
+
+  Offset<String> CreateSharedString(const std::string &str) {
+    return CreateSharedString(str.c_str(), str.length());
+  }
+
   uoffset_t EndVector(size_t len) {
     return PushElement(static_cast<uoffset_t>(len));
   }
 
   void StartVector(size_t len, size_t elemsize) {
+    // Elements and length field, plus the worst case alignment below.
+    buf_.ensure_contiguous(len * elemsize + sizeof(uoffset_t) +
+                           std::max(elemsize, sizeof(uoffset_t)));
     PreAlign<uoffset_t>(len * elemsize);
     PreAlign(len * elemsize, elemsize);  // Just in case elemsize > uoffset_t.
   }
@@ -658,11 +1432,42 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
   template<typename T> Offset<Vector<T>> CreateVector(const T *v, size_t len) {
     NotNested();
     StartVector(len, sizeof(T));
-    for (auto i = len; i > 0; ) {
-      PushElement(v[--i]);
+    PushElements(v, len, typename std::is_scalar<T>::type());
+    return Offset<Vector<T>>(EndVector(len));
+  }
+
+  // std::vector<bool> is packed, so it is stored as a vector of bytes, which
+  // is also what the generated code uses for [bool].
+  Offset<Vector<uint8_t>> CreateVector(const std::vector<bool> &v) {
+    NotNested();
+    StartVector(v.size(), sizeof(uint8_t));
+    auto dest = buf_.make_space(v.size());
+    for (size_t i = 0; i < v.size(); i++) dest[i] = v[i];
+    return Offset<Vector<uint8_t>>(EndVector(v.size()));
+  }
+
+  // Store enum values as a vector of T, the type the schema declares for
+  // them (which generally differs from the size of the C++ enum), e.g.:
+  // CreateVectorOfEnums<int8_t>(colors, len).
+  template<typename T, typename E> Offset<Vector<T>> CreateVectorOfEnums(
+                                                      const E *v, size_t len) {
+    NotNested();
+    StartVector(len, sizeof(T));
+    if (sizeof(T) == sizeof(E)) {
+      PushElements(reinterpret_cast<const T *>(v), len, std::true_type());
+    } else {
+      auto dest = buf_.make_space(len * sizeof(T));
+      for (size_t i = 0; i < len; i++) {
+        WriteScalar(dest + i * sizeof(T), static_cast<T>(v[i]));
+      }
     }
     return Offset<Vector<T>>(EndVector(len));
   }
+
+  template<typename T, typename E> Offset<Vector<T>> CreateVectorOfEnums(
+                                                     const std::vector<E> &v) {
+    return CreateVectorOfEnums<T>(v.data(), v.size());
+  }
   
   // Specialized version for non-copying use cases. Data to be written later.
   // After calling this function, GetBufferPointer() can be cast to the
@@ -688,6 +1493,89 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
     return CreateVector(v.data(), v.size());
   }
 
+  // Create a vector of tables sorted by their key field (see the key
+  // attribute), which can then be searched with Vector::LookupByKey().
+  // Sorts "v" in place. The tables are compared where they are in the buffer,
+  // so this doesn't work with UseChunks().
+  template<typename T> Offset<Vector<Offset<T>>> CreateVectorOfSortedTables(
+                                                    Offset<T> *v, size_t len) {
+    buf_.flatten();  // Tables must be adjacent to what they refer to.
+    std::stable_sort(v, v + len, [this](Offset<T> a, Offset<T> b) {
+      auto table_a = reinterpret_cast<const T *>(buf_.data_at(a.o));
+      auto table_b = reinterpret_cast<const T *>(buf_.data_at(b.o));
+      return table_a->KeyCompareLessThan(table_b);
+    });
+    return CreateVector(v, len);
+  }
+
+  template<typename T> Offset<Vector<Offset<T>>> CreateVectorOfSortedTables(
+                                                 std::vector<Offset<T>> *v) {
+    return CreateVectorOfSortedTables(v->data(), v->size());
+  }
+
+  // Create a hash index (see the hash_index attribute) for a vector of
+  // tables with a key field, given in the same order as in the vector.
+  template<typename T> Offset<Vector<uint32_t>> CreateHashIndex(
+                                              const Offset<T> *v, size_t len) {
+    buf_.flatten();  // Tables must be adjacent to what they refer to.
+    std::vector<uint32_t> hashes(len);
+    for (size_t i = 0; i < len; i++) {
+      hashes[i] = reinterpret_cast<const T *>(buf_.data_at(v[i].o))->KeyHash();
+    }
+    return CreateHashIndex(hashes.data(), len);
+  }
+
+  template<typename T> Offset<Vector<uint32_t>> CreateHashIndex(
+                                           const std::vector<Offset<T>> &v) {
+    return CreateHashIndex(v.data(), v.size());
+  }
+
+  // Same, given the hashes of the keys (see HashString() / HashScalar()).
+  // The index is an open addressing table at most half full, holding the
+  // position of each element + 1 (0 for empty slots).
+  Offset<Vector<uint32_t>> CreateHashIndex(const uint32_t *hashes,
+                                           size_t len) {
+    std::vector<uint32_t> slots;
+    if (len) {
+      size_t size = 2;
+      while (size < len * 2) size *= 2;
+      slots.resize(size);
+      for (size_t i = 0; i < len; i++) {
+        auto slot = hashes[i] & (size - 1);
+        while (slots[slot]) slot = (slot + 1) & (size - 1);
+        slots[slot] = static_cast<uint32_t>(i + 1);
+      }
+    }
+    return CreateVector(slots);
+  }
+
+  // Create a vector of bytes without copying them: the buffer refers to
+  // memory owned by the caller, which must stay valid until the buffer has
+  // been written out. GetBufferSegments() returns it as a segment of its own,
+  // whereas GetBufferPointer() and Release() copy it in.
+  Offset<Vector<uint8_t>> CreateExternalVector(const uint8_t *bytes,
+                                               size_t len) {
+    NotNested();
+    // Keep what comes after the bytes aligned, as if they had been copied.
+    PreAlign(len, sizeof(largest_scalar_t));
+    buf_.push_external(bytes, len);
+    return Offset<Vector<uint8_t>>(EndVector(len));
+  }
+
+  // Store a finished buffer as a vector of bytes, for a field with the
+  // nested_flatbuffer attribute. Its start is aligned like that of any
+  // buffer, so the nested root can be read in place.
+  Offset<Vector<uint8_t>> CreateNestedFlatBuffer(const uint8_t *buf,
+                                                 size_t len) {
+    NotNested();
+    buf_.ensure_contiguous(len + sizeof(uoffset_t) + sizeof(largest_scalar_t));
+    if (sizeof(largest_scalar_t) > minalign_)
+      minalign_ = sizeof(largest_scalar_t);
+    PreAlign(len, sizeof(largest_scalar_t));
+    PushBytes(buf, len);
+    return Offset<Vector<uint8_t>>(EndVector(len));
+  }
+
   template<typename T> Offset<Vector<const T *>> CreateVectorOfStructs(
                                                       const T *v, size_t len) {
     NotNested();
@@ -708,6 +1596,8 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
   // FlatBuffers file header.
   template<typename T> void Finish(Offset<T> root,
                                    const char *file_identifier = nullptr) {
+    buf_.ensure_contiguous(minalign_ + sizeof(uoffset_t) +
+                           kFileIdentifierLength);
     // This will cause the whole buffer to be aligned.
     PreAlign(sizeof(uoffset_t) + (file_identifier ? kFileIdentifierLength : 0),
              minalign_);
@@ -717,6 +1607,14 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
                 kFileIdentifierLength);
     }
     PushElement(ReferTo(root.o));  // Location of root.
+    if (num_size_hints_) {
+      if (size_hints_.size() < num_size_hints_) {
+        size_hints_.push_back(GetSize());
+      } else {
+        size_hints_[next_size_hint_] = GetSize();
+      }
+      next_size_hint_ = (next_size_hint_ + 1) % num_size_hints_;
+    }
   }
 
  private:
@@ -729,18 +1627,129 @@ class FlatBufferBuilder FLATBUFFERS_FINAL_CLASS {
     voffset_t id;
   };
 
-  simple_allocator default_allocator;
+  // A field kept aside by SortFields(), its value is in staged_bytes_.
+  struct StagedField {
+    size_t pos;
+    size_t size;
+    size_t alignment;
+    voffset_t id;
+    bool is_offset;  // Value is a uoffset_t relative to the end.
+  };
+
+  void StageField(voffset_t field, const void *value, size_t size,
+                  size_t alignment, bool is_offset) {
+    StagedField sf = { staged_bytes_.size(), size, alignment, field,
+                       is_offset };
+    auto bytes = reinterpret_cast<const uint8_t *>(value);
+    staged_bytes_.insert(staged_bytes_.end(), bytes, bytes + size);
+    staged_fields_.push_back(sf);
+  }
+
+  void WriteStagedFields() {
+    std::stable_sort(staged_fields_.begin(), staged_fields_.end(),
+                     [](const StagedField &a, const StagedField &b) {
+      return a.alignment > b.alignment;
+    });
+    for (auto it = staged_fields_.begin(); it != staged_fields_.end(); ++it) {
+      auto value = &staged_bytes_[it->pos];
+      if (it->is_offset) {
+        uoffset_t off;
+        memcpy(&off, value, sizeof(uoffset_t));
+        TrackField(it->id, PushElement(ReferTo(off)));
+      } else {
+        Align(it->alignment);
+        PushBytes(value, it->size);
+        TrackField(it->id, GetSize());
+      }
+    }
+    staged_fields_.clear();
+    staged_bytes_.clear();
+  }
+
+  static uint32_t HashVtable(const uint8_t *vt) {
+    return HashBytes(vt, ReadScalar<voffset_t>(vt));
+  }
+
+  // Returns the slot in the vtable index that holds a vtable identical to
+  // "vt", or the empty slot (holding 0) where it should be inserted.
+  uoffset_t *FindVtable(const uint8_t *vt) {
+    auto vt_size = ReadScalar<voffset_t>(vt);
+    auto mask = vtables_.size() - 1;
+    for (auto i = HashVtable(vt) & mask; ; i = (i + 1) & mask) {
+      auto &slot = vtables_[i];
+      if (!slot) return &slot;
+      auto vt2 = buf_.data_at(slot);
+      if (ReadScalar<voffset_t>(vt2) == vt_size && !memcmp(vt2, vt, vt_size))
+        return &slot;
+    }
+  }
+
+  // Doubles the vtable index, rehashing the vtables from the buffer (their
+  // offsets from the end of the buffer stay valid across reallocations).
+  void GrowVtableIndex() {
+    std::vector<uoffset_t> old_vtables(vtables_.size() * 2);
+    old_vtables.swap(vtables_);
+    for (auto it = old_vtables.begin(); it != old_vtables.end(); ++it) {
+      if (*it) *FindVtable(buf_.data_at(*it)) = *it;
+    }
+  }
+
+  // Same as FindVtable, for the string pool. Hashes the candidate string
+  // in place, so a lookup that hits doesn't touch the buffer or allocate.
+  uoffset_t *FindPooledString(const char *str, size_t len) {
+    auto mask = string_pool_.size() - 1;
+    auto hash = HashBytes(reinterpret_cast<const uint8_t *>(str), len);
+    for (auto i = hash & mask; ; i = (i + 1) & mask) {
+      auto &slot = string_pool_[i];
+      if (!slot) return &slot;
+      auto str2 = reinterpret_cast<const String *>(buf_.data_at(slot));
+      if (str2->size() == len && !memcmp(str2->c_str(), str, len))
+        return &slot;
+    }
+  }
+
+  void GrowStringPool() {
+    std::vector<uoffset_t> old_pool(string_pool_.size() * 2);
+    old_pool.swap(string_pool_);
+    for (auto it = old_pool.begin(); it != old_pool.end(); ++it) {
+      if (!*it) continue;
+      auto str = reinterpret_cast<const String *>(buf_.data_at(*it));
+      *FindPooledString(str->c_str(), str->size()) = *it;
+    }
+  }
 
   vector_downward buf_;
 
   // Accumulating offsets of table members while it is being built.
   std::vector<FieldLoc> offsetbuf_;
 
-  std::vector<uoffset_t> vtables_;  // todo: Could make this into a map?
+  // Open addressing hash index of the vtables written so far, keyed on their
+  // contents. Slots hold offsets from the end of the buffer, 0 if empty.
+  std::vector<uoffset_t> vtables_;
+  size_t num_vtables_;
+  size_t max_vtables_;
+
+  // Same kind of index for strings created with CreateSharedString,
+  // allocated on first use.
+  std::vector<uoffset_t> string_pool_;
+  size_t num_pooled_strings_;
+
+  // Sizes of recently finished buffers (see LearnInitialSize()), used as a
+  // ring of num_size_hints_ entries.
+  std::vector<uoffset_t> size_hints_;
+  size_t num_size_hints_;
+  size_t next_size_hint_;
+
+  size_t num_clears_;
 
   size_t minalign_;
 
   bool force_defaults_;  // Serialize values equal to their defaults anyway.
+
+  // Fields kept aside until EndTable() when sort_fields_ is set.
+  bool sort_fields_;
+  std::vector<StagedField> staged_fields_;
+  std::vector<uint8_t> staged_bytes_;
 };
 
 // Helpers to get a typed pointer to the root object contained in the buffer.
@@ -760,14 +1769,61 @@ inline bool BufferHasIdentifier(const void *buf, const char *identifier) {
                  identifier, FlatBufferBuilder::kFileIdentifierLength) == 0;
 }
 
+// What a Verifier has checked so far, see Verifier::GetStats().
+struct VerifierStats {
+  VerifierStats()
+    : tables(0), vectors(0), strings(0), bytes(0), max_depth(0),
+      nanoseconds(0) {}
+
+  size_t tables;         // Counting shared tables each time they're reached.
+  size_t vectors;        // Not counting strings.
+  size_t strings;
+  size_t bytes;          // In vectors and strings, including their sizes.
+  size_t max_depth;      // Of nested tables.
+  uint64_t nanoseconds;  // In VerifyBuffer(), see Verifier::MeasureTime().
+};
+
+// Returns the current time in nanoseconds, from any fixed point. See
+// Verifier::MeasureTime().
+typedef uint64_t (*ClockFunction)();
+
+// Runs job(context, i) for each i below num_jobs, possibly at the same time,
+// and returns once all of them are done. See Verifier::UseThreads().
+typedef void (*RunJobsFunction)(size_t num_jobs,
+                                void (*job)(void *context, size_t i),
+                                void *context);
+
 // Helper class to verify the integrity of a FlatBuffer
 class Verifier FLATBUFFERS_FINAL_CLASS {
  public:
+  // "_max_bytes" limits the bytes in vectors and strings, each time they
+  // are reached. Offsets to the same data from many places can make a small
+  // buffer look huge, this bounds that.
   Verifier(const uint8_t *buf, size_t buf_len, size_t _max_depth = 64,
-           size_t _max_tables = 1000000)
+           size_t _max_tables = 1000000,
+           size_t _max_bytes = std::numeric_limits<size_t>::max())
     : buf_(buf), end_(buf + buf_len), depth_(0), max_depth_(_max_depth),
-      num_tables_(0), max_tables_(_max_tables)
-    {}
+      max_tables_(_max_tables), max_bytes_(_max_bytes),
+      num_threads_(1), run_jobs_(nullptr), clock_(nullptr),
+      check_utf8_(false) {}
+
+  // Counts of what was checked, for monitoring the cost of verification.
+  // They keep adding up if the verifier is used for multiple buffers.
+  const VerifierStats &GetStats() const { return stats_; }
+
+  // Makes VerifyBuffer() add the time it takes to the stats, as read from
+  // "clock" (usually NowNanoseconds() from flatbuffers/util.h, which keeps
+  // <chrono> out of this header). Off by default (nullptr), since reading
+  // the clock costs about as much as verifying a small buffer.
+  void MeasureTime(ClockFunction clock) { clock_ = clock; }
+
+  // Splits large vectors of tables over "num_threads" threads, started by
+  // "run_jobs" (usually RunOnThreads() from flatbuffers/util.h, which keeps
+  // <thread> out of this header). See VerifyVectorOfTables().
+  void UseThreads(size_t num_threads, RunJobsFunction run_jobs) {
+    num_threads_ = run_jobs ? num_threads : 1;
+    run_jobs_ = run_jobs;
+  }
 
   // Central location where any verification failures register.
   bool Check(bool ok) const {
@@ -802,52 +1858,192 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
 
   // Verify a pointer (may be NULL) to string.
   bool Verify(const String *str) const {
-    const uint8_t *end;
-    return !str ||
-           (VerifyVector(reinterpret_cast<const uint8_t *>(str), 1, &end) &&
-            Verify(end, 1) &&      // Must have terminator
-            Check(*end == '\0'));  // Terminating byte must be 0.
-  }
-
-  // Common code between vectors and strings.
+    if (!str) return true;
+    auto p = reinterpret_cast<const uint8_t *>(str);
+    if (!Check(p >= buf_ && p < end_)) return false;
+    auto len = VerifyStringAt(p, static_cast<size_t>(end_ - p));
+    if (len == kBadString) return false;
+    stats_.strings++;
+    stats_.bytes += sizeof(uoffset_t) + len;
+    if (!Check(stats_.bytes <= max_bytes_)) return false;
+    return Check(p[sizeof(uoffset_t) + len] == '\0') &&  // Terminator.
+           (!check_utf8_ || Check(IsValidUTF8(p + sizeof(uoffset_t), len)));
+  }
+
+  // Verify a vector of elements of "elem_size" bytes, setting "end" to the
+  // byte past it.
   bool VerifyVector(const uint8_t *vec, size_t elem_size,
                     const uint8_t **end) const {
     // Check we can read the size field.
     if (!Verify<uoffset_t>(vec)) return false;
-    // Check the whole array. If this is a string, the byte past the array
-    // must be 0.
+    // Check the whole array.
     auto size = ReadScalar<uoffset_t>(vec);
     auto byte_size = sizeof(size) + elem_size * size;
     *end = vec + byte_size;
+    stats_.vectors++;
+    stats_.bytes += byte_size;
+    if (!Check(stats_.bytes <= max_bytes_)) return false;
     return Verify(vec, byte_size);
   }
 
   // Special case for string contents, after the above has been called.
+  // All strings are checked in one pass, which only branches when one of
+  // them runs past the end of the buffer or the byte limit. Their
+  // terminators are checked together at the end.
   bool VerifyVectorOfStrings(const Vector<Offset<String>> *vec) const {
-      if (vec) {
-        for (uoffset_t i = 0; i < vec->size(); i++) {
-          if (!Verify(vec->Get(i))) return false;
-        }
-      }
-      return true;
+    if (!vec) return true;
+    auto elem = vec->Data();
+    auto num_strings = vec->size();
+    uint8_t terminators = 0;
+    size_t bytes = 0;
+    // Checked before each string, so offsets to the same large string can't
+    // make it do more work than the limit allows.
+    auto max_bytes = stats_.bytes < max_bytes_ ? max_bytes_ - stats_.bytes
+                                               : 0;
+    for (uoffset_t i = 0; i < num_strings; i++, elem += sizeof(uoffset_t)) {
+      // The vector was verified, so there's room for the offset.
+      auto room = static_cast<size_t>(end_ - elem);
+      auto offset = ReadScalar<uoffset_t>(elem);
+      if (!Check(offset < room)) return false;
+      auto str = elem + offset;
+      auto len = VerifyStringAt(str, room - offset);
+      if (len == kBadString) return false;
+      terminators |= str[sizeof(uoffset_t) + len];
+      bytes += sizeof(uoffset_t) + len;
+      if (!Check(bytes <= max_bytes)) return false;
+      if (check_utf8_ && !Check(IsValidUTF8(str + sizeof(uoffset_t), len)))
+        return false;
+    }
+    stats_.strings += num_strings;
+    stats_.bytes += bytes;
+    return Check(terminators == 0);
   }
 
+  // Whether strings must also be valid UTF-8, off by default. This doesn't
+  // cost much for strings that are mostly ASCII. A string is checked each
+  // time it is reached, so for untrusted buffers also pass "_max_bytes" to
+  // the constructor: without it, many offsets to one large string make for
+  // an unbounded amount of work.
+  void CheckUTF8(bool check) { check_utf8_ = check; }
+
   // Special case for table contents, after the above has been called.
   template<typename T> bool VerifyVectorOfTables(const Vector<Offset<T>> *vec) {
-    if (vec) {
-      for (uoffset_t i = 0; i < vec->size(); i++) {
-        if (!vec->Get(i)->Verify(*this)) return false;
+    return VerifyVectorOfTables(vec, [](Verifier &verifier, const T *table) {
+      return table->Verify(verifier);
+    });
+  }
+
+  // Same, with "verify_table" called to check each table, for when their
+  // type isn't known at compile time.
+  // If the verifier has threads to spare and the vector is large, it is
+  // split over them, each with a copy of this verifier. The copies share
+  // what's left of the table limit, and their counts are added up after,
+  // so the result is the same as when verifying on one thread. Tables in
+  // the vector get the threads that the split didn't use.
+  template<typename T, typename F> bool VerifyVectorOfTables(
+                                     const Vector<Offset<T>> *vec,
+                                     F verify_table) {
+    if (!vec) return true;
+    auto size = vec->size();
+    auto num_workers = std::min<size_t>(num_threads_,
+                                        size / kMinTablesPerThread);
+    if (num_workers < 2) {
+      for (uoffset_t i = 0; i < size; i++) {
+        if (!verify_table(*this, vec->Get(i))) return false;
+      }
+      return true;
+    }
+    std::vector<Verifier> workers(num_workers, *this);
+    std::vector<uint8_t> results(num_workers, false);
+    auto verify_range = [&](size_t worker) {
+      auto &verifier = workers[worker];
+      verifier.stats_ = VerifierStats();
+      verifier.max_tables_ = max_tables_ - stats_.tables;
+      verifier.max_bytes_ = max_bytes_ - stats_.bytes;
+      verifier.num_threads_ = num_threads_ / num_workers;
+      auto end = static_cast<uoffset_t>(size * (worker + 1) / num_workers);
+      for (auto i = static_cast<uoffset_t>(size * worker / num_workers);
+           i < end; i++) {
+        if (!verify_table(verifier, vec->Get(i))) return;
       }
+      results[worker] = true;
+    };
+    typedef decltype(verify_range) Job;
+    run_jobs_(num_workers, [](void *job, size_t worker) {
+      (*static_cast<Job *>(job))(worker);
+    }, &verify_range);
+    for (size_t i = 0; i < num_workers; i++) {
+      if (!results[i]) return false;
+      auto &stats = workers[i].stats_;
+      stats_.tables += stats.tables;
+      stats_.vectors += stats.vectors;
+      stats_.strings += stats.strings;
+      stats_.bytes += stats.bytes;
+      stats_.max_depth = std::max(stats_.max_depth, stats.max_depth);
+    }
+    return Check(stats_.tables <= max_tables_ && stats_.bytes <= max_bytes_);
+  }
+
+  // Check a hash index (see the hash_index attribute), after the index
+  // itself and the vector it indexes have been verified.
+  template<typename T> bool VerifyHashIndex(const Vector<uint32_t> *index,
+                                            const Vector<T> *vec) const {
+    if (!index) return true;
+    auto size = index->size();
+    if (!Check((size & (size - 1)) == 0)) return false;  // Power of 2.
+    auto len = vec ? vec->size() : 0;
+    for (uoffset_t i = 0; i < size; i++) {
+      if (!Check(index->Get(i) <= len)) return false;
     }
     return true;
   }
 
+  // Verify a buffer nested in this one (see the nested_flatbuffer
+  // attribute), after the vector holding it has been verified. Its tables
+  // count towards the same depth and table limits as this buffer.
+  template<typename T> bool VerifyNestedFlatBuffer(
+                                               const Vector<uint8_t> *buf) {
+    return VerifyNestedFlatBuffer(buf, [&](const uint8_t *root) {
+      return reinterpret_cast<const T *>(root)->Verify(*this);
+    });
+  }
+
+  // Same, with "verify_root" called to check the root table of the nested
+  // buffer (after its offset was checked), for when its type isn't known at
+  // compile time.
+  template<typename F> bool VerifyNestedFlatBuffer(const Vector<uint8_t> *buf,
+                                                   F verify_root) {
+    if (!buf || !buf->size()) return true;
+    auto outer_buf = buf_, outer_end = end_;
+    buf_ = buf->Data();
+    end_ = buf_ + buf->size();
+    auto ok = Verify<uoffset_t>(buf_) &&
+              verify_root(buf_ + ReadScalar<uoffset_t>(buf_));
+    buf_ = outer_buf;
+    end_ = outer_end;
+    return ok;
+  }
+
   // Verify this whole buffer, starting with root type T.
   template<typename T> bool VerifyBuffer() {
     // Call T::Verify, which must be in the generated code for this type.
-    return Verify<uoffset_t>(buf_) &&
-      reinterpret_cast<const T *>(buf_ + ReadScalar<uoffset_t>(buf_))->
-        Verify(*this);
+    return VerifyBuffer([&](const uint8_t *root) {
+      return reinterpret_cast<const T *>(root)->Verify(*this);
+    });
+  }
+
+  // Same, with "verify_root" called to check the root table (after its
+  // offset was checked), for when its type isn't known at compile time.
+  template<typename F> bool VerifyBuffer(F verify_root) {
+    if (!clock_) {
+      return Verify<uoffset_t>(buf_) &&
+             verify_root(buf_ + ReadScalar<uoffset_t>(buf_));
+    }
+    auto start = clock_();
+    auto ok = Verify<uoffset_t>(buf_) &&
+              verify_root(buf_ + ReadScalar<uoffset_t>(buf_));
+    stats_.nanoseconds += clock_() - start;
+    return ok;
   }
 
   // Called at the start of a table to increase counters measuring data
@@ -856,8 +2052,9 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   // with EndTable().
   bool VerifyComplexity() {
     depth_++;
-    num_tables_++;
-    return Check(depth_ <= max_depth_ && num_tables_ <= max_tables_);
+    stats_.tables++;
+    if (depth_ > stats_.max_depth) stats_.max_depth = depth_;
+    return Check(depth_ <= max_depth_ && stats_.tables <= max_tables_);
   }
 
   // Called at the end of a table to pop the depth count.
@@ -867,12 +2064,34 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   }
 
  private:
+  // Smaller vectors aren't worth starting threads for.
+  static const size_t kMinTablesPerThread = 1024;
+
+  static const size_t kBadString = ~static_cast<size_t>(0);
+
+  // Checks a string at "str" with "room" bytes left in the buffer fits,
+  // with its size field and terminator, and returns its length (or
+  // kBadString). Each is a single comparison on the room left, which is
+  // correct however large the size field is.
+  size_t VerifyStringAt(const uint8_t *str, size_t room) const {
+    if (!Check(room > sizeof(uoffset_t))) return kBadString;
+    size_t len = ReadScalar<uoffset_t>(str);
+    if (!Check(len < room - sizeof(uoffset_t))) return kBadString;
+    return len;
+  }
+
   const uint8_t *buf_;
   const uint8_t *end_;
   size_t depth_;
   size_t max_depth_;
-  size_t num_tables_;
   size_t max_tables_;
+  size_t max_bytes_;
+  size_t num_threads_;
+  RunJobsFunction run_jobs_;
+  ClockFunction clock_;
+  bool check_utf8_;
+  // Mutable, since the checks that don't change anything else are const.
+  mutable VerifierStats stats_;
 };
 
 // "structs" are flat structures that do not have an offset table, thus
@@ -965,6 +2184,52 @@ class Table {
     return GetOptionalFieldOffset(field) != 0;
   }
 
+  // Like CheckField() for the fields with ids first .. first + count - 1
+  // (count <= 64) at once: bit i of the result is set if field first + i
+  // is present. Fields past the end of the vtable are not present.
+  uint64_t PresentFieldBits(size_t first, size_t count) const {
+    assert(count <= 64);
+    auto vtable = data_ - ReadScalar<soffset_t>(data_);
+    auto vtsize = ReadScalar<voffset_t>(vtable);
+    // The vtable starts with its own size and the table size.
+    size_t num_entries = vtsize / sizeof(voffset_t);
+    if (first + 2 >= num_entries) return 0;
+    num_entries -= 2;
+    auto entries = vtable + 2 * sizeof(voffset_t) + first * sizeof(voffset_t);
+    count = std::min(count, num_entries - first);
+    uint64_t bits = 0;
+    size_t i = 0;
+    #if FLATBUFFERS_LITTLEENDIAN
+      // 4 entries at a time: set the top bit of each non-zero 16 bit lane,
+      // then gather those 4 bits with a multiply.
+      for (; i + 4 <= count; i += 4) {
+        uint64_t lanes;
+        memcpy(&lanes, entries + i * sizeof(voffset_t), sizeof(lanes));
+        const uint64_t kLow = 0x7FFF7FFF7FFF7FFFULL;
+        auto nonzero = (((lanes & kLow) + kLow) | lanes) & ~kLow;
+        bits |= (((nonzero >> 15) * 0x0001000200040008ULL) >> 48) << i;
+      }
+    #endif
+    for (; i < count; i++) {
+      if (ReadScalar<voffset_t>(entries + i * sizeof(voffset_t)))
+        bits |= 1ULL << i;
+    }
+    return bits;
+  }
+
+  // The same for all fields with ids below N, for tables with too many
+  // fields for PresentFieldBits(), as a B = std::bitset<N> (which is left to
+  // the caller to include).
+  template<typename B> B PresentFields() const {
+    B present;
+    auto n = present.size();
+    for (size_t first = 0; first < n; first += 64) {
+      present |= B(PresentFieldBits(first, std::min<size_t>(64, n - first)))
+                 << first;
+    }
+    return present;
+  }
+
   // Verify the vtable of this table.
   // Call this once per table, followed by VerifyField once per field.
   bool VerifyTableStart(Verifier &verifier) const {
@@ -1004,6 +2269,116 @@ class Table {
   uint8_t data_[1];
 };
 
+// Reads the fields of one table like Table does, but having looked up its
+// vtable just once, which is faster when reading many fields of the same
+// table. The generated XView classes are built on this, use them as local
+// variables so the compiler can keep these members in registers.
+class TableView {
+ public:
+  explicit TableView(const void *table)
+    : data_(reinterpret_cast<const uint8_t *>(table)),
+      vtable_(data_ - ReadScalar<soffset_t>(data_)),
+      vtsize_(ReadScalar<voffset_t>(vtable_)) {}
+
+  voffset_t GetOptionalFieldOffset(voffset_t field) const {
+    return field < vtsize_ ? ReadScalar<voffset_t>(vtable_ + field) : 0;
+  }
+
+  template<typename T> T GetField(voffset_t field, T defaultval) const {
+    auto field_offset = GetOptionalFieldOffset(field);
+    return field_offset ? ReadScalar<T>(data_ + field_offset) : defaultval;
+  }
+
+  template<typename P> P GetPointer(voffset_t field) const {
+    auto field_offset = GetOptionalFieldOffset(field);
+    auto p = data_ + field_offset;
+    return field_offset
+      ? reinterpret_cast<P>(p + ReadScalar<uoffset_t>(p))
+      : nullptr;
+  }
+
+  template<typename P> P GetStruct(voffset_t field) const {
+    auto field_offset = GetOptionalFieldOffset(field);
+    return field_offset ? reinterpret_cast<P>(data_ + field_offset) : nullptr;
+  }
+
+  bool CheckField(voffset_t field) const {
+    return GetOptionalFieldOffset(field) != 0;
+  }
+
+ private:
+  const uint8_t *data_;
+  const uint8_t *vtable_;
+  voffset_t vtsize_;
+};
+
+// Reads one scalar field from every table in "vec" into "column", which must
+// have room for vec->size() elements. F is one of the generated field
+// descriptors, e.g. MonsterFields::hp, enums are read as their underlying
+// type.
+// Tables are prefetched a few elements ahead, and the field offset is only
+// looked up again when the vtable changes, which in vectors of tables
+// created in a loop it usually doesn't (so vtables aren't prefetched, that
+// would cost an extra read of each table ahead of time).
+template<typename F, typename T>
+void ExtractColumn(const Vector<Offset<T>> *vec,
+                   typename F::value_type *column) {
+  static_assert(std::is_same<typename F::table_type, T>::value,
+                "field descriptor is for a different table");
+  typedef typename F::value_type V;
+  const uoffset_t kPrefetchDistance = 16;
+  auto elems = vec->Data();
+  auto size = vec->size();
+  auto table_at = [&](uoffset_t i) {
+    auto p = elems + i * sizeof(uoffset_t);
+    return p + ReadScalar<uoffset_t>(p);
+  };
+  const uint8_t *vtable = nullptr;
+  voffset_t field_offset = 0;
+  for (uoffset_t i = 0; i < size; i++) {
+    if (i + kPrefetchDistance < size)
+      FLATBUFFERS_PREFETCH(table_at(i + kPrefetchDistance));
+    auto table = table_at(i);
+    auto table_vtable = table - ReadScalar<soffset_t>(table);
+    if (table_vtable != vtable) {
+      vtable = table_vtable;
+      field_offset = F::offset < ReadScalar<voffset_t>(vtable)
+        ? ReadScalar<voffset_t>(vtable + F::offset)
+        : 0;
+    }
+    column[i] = field_offset
+      ? ReadScalar<V>(table + field_offset)
+      : F::default_value();
+  }
+}
+
+// As above, but returns the column as a std::vector.
+template<typename F, typename T>
+std::vector<typename F::value_type> ExtractColumn(
+                                      const Vector<Offset<T>> *vec) {
+  std::vector<typename F::value_type> column(vec->size());
+  if (!column.empty()) ExtractColumn<F>(vec, column.data());
+  return column;
+}
+
+// The root of a buffer nested in a vector of bytes (see the
+// nested_flatbuffer attribute), or nullptr if the vector is absent or empty.
+template<typename T> const T *GetNestedRoot(const Vector<uint8_t> *buf) {
+  return buf && buf->size() ? GetRoot<T>(buf->Data()) : nullptr;
+}
+
+// Same, but only if the nested buffer verifies on its own, for when the
+// buffer around it wasn't verified (or was verified by a version of the
+// schema that didn't know it held a nested buffer).
+template<typename T> const T *GetVerifiedNestedRoot(
+                                const Vector<uint8_t> *buf,
+                                size_t max_depth = 64,
+                                size_t max_tables = 1000000) {
+  if (!buf || !buf->size()) return nullptr;
+  Verifier verifier(buf->Data(), buf->size(), max_depth, max_tables);
+  return verifier.VerifyBuffer<T>() ? GetRoot<T>(buf->Data()) : nullptr;
+}
+
 // Utility function for reverse lookups on the EnumNames*() functions
 // (in the generated C++ code)
 // names must be NULL terminated.
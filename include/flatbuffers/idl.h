@@ -192,11 +192,13 @@ struct Definition {
 };
 
 struct FieldDef : public Definition {
-  FieldDef() : deprecated(false), required(false), id(0), padding(0) {}
+  FieldDef() : deprecated(false), required(false), key(false), id(0),
+               padding(0) {}
 
   Value value;
   bool deprecated;
   bool required;
+  bool key;  // Vectors of this table can be sorted and searched by it.
   int id;
   size_t padding;  // Bytes to always pad after this field.
 };
@@ -206,6 +208,7 @@ struct StructDef : public Definition {
     : fixed(false),
       predecl(true),
       sortbysize(true),
+      has_key(false),
       minalign(1),
       bytesize(0)
     {}
@@ -220,6 +223,7 @@ struct StructDef : public Definition {
   bool fixed;       // If it's struct, not a table.
   bool predecl;     // If it's used before it was defined.
   bool sortbysize;  // Whether fields come in the declaration or size order.
+  bool has_key;     // Whether one of the fields has the key attribute.
   size_t minalign;  // What the whole object needs to be aligned to.
   size_t bytesize;  // Size if fixed.
 };
@@ -277,7 +281,8 @@ class Parser {
       cursor_(nullptr),
       line_(1),
       numeric_(false),
-      proto_mode_(proto_mode) {
+      proto_mode_(proto_mode),
+      share_strings_(false) {
     // Just in case none are declared:
     namespaces_.push_back(new Namespace());
     known_attributes_.insert("alias");
@@ -288,6 +293,9 @@ class Parser {
     known_attributes_.insert("bit_flags");
     known_attributes_.insert("original_order");
     known_attributes_.insert("nested_flatbuffer");
+    known_attributes_.insert("fixed_layout");
+    known_attributes_.insert("key");
+    known_attributes_.insert("hash_index");
   }
 
   ~Parser() {
@@ -317,6 +325,10 @@ class Parser {
   // Mark all definitions as already having code generated.
   void MarkGenerated();
 
+  // Store identical strings in JSON data only once, using
+  // FlatBufferBuilder::CreateSharedString.
+  void ShareStrings(bool share) { share_strings_ = share; }
+
  private:
   int64_t ParseHexNum(int nibbles);
   void Next();
@@ -335,7 +347,11 @@ class Parser {
   uoffset_t ParseTableUnsorted(const StructDef &struct_def);
   void SerializeStruct(const StructDef &struct_def, const Value &val);
   void AddVector(bool sortbysize, int count);
+  void SortByKey(const StructDef &struct_def,
+                 std::vector<std::pair<Value, FieldDef *>>::iterator first,
+                 std::vector<std::pair<Value, FieldDef *>>::iterator last);
   uoffset_t ParseVector(const Type &type);
+  size_t AddHashIndices(const StructDef &struct_def, size_t fieldn);
   void ParseMetaData(Definition &def);
   bool TryTypedValue(int dtoken, bool check, Value &e, BaseType req);
   void ParseSingleValue(Value &e);
@@ -367,6 +383,7 @@ class Parser {
   int token_;
   bool numeric_;
   bool proto_mode_;
+  bool share_strings_;
   std::string attribute_;
   std::vector<std::string> doc_comment_;
 
@@ -376,6 +393,62 @@ class Parser {
   std::set<std::string> known_attributes_;
 };
 
+// Verifies buffers of a schema loaded into a Parser at runtime, making the
+// same checks as the Verify() functions generated for it.
+// The schema is compiled into a list of instructions per table, which
+// Verify() interprets. See idl_verifier.cpp.
+class SchemaVerifier {
+ public:
+  // For buffers with root type "root_struct_def" (by default the root type
+  // of the schema). The Parser isn't needed after construction.
+  explicit SchemaVerifier(const Parser &parser,
+                          const StructDef *root_struct_def = nullptr);
+
+  // Verify the whole buffer "buf", same as the generated VerifyXBuffer().
+  // Always false if there was no root type.
+  bool Verify(const uint8_t *buf, size_t buf_len, size_t max_depth = 64,
+              size_t max_tables = 1000000,
+              size_t max_bytes = std::numeric_limits<size_t>::max()) const;
+  // The same, for the buffer "verifier" was constructed with (e.g. to verify
+  // on multiple threads, see Verifier::UseThreads()).
+  bool Verify(Verifier &verifier) const;
+
+ private:
+  enum Opcode {
+    kOpField,            // Inline scalar or struct of "arg" bytes.
+    kOpString,
+    kOpTable,            // Table of which the instructions start at "arg".
+    kOpVector,           // Vector of elements of "arg" bytes.
+    kOpVectorOfStrings,
+    kOpVectorOfTables,   // Vector of the tables of kOpTable.
+    kOpUnion,            // Union "arg", with its type in field "aux".
+    kOpNested,           // Nested buffer with the root table of kOpTable.
+    kOpHashIndex,        // Hash index for the vector in field "aux".
+    kOpEnd               // End of a table.
+  };
+
+  struct Instruction {
+    uint8_t op;
+    uint8_t required;
+    voffset_t field;
+    voffset_t aux;
+    uint32_t arg;
+  };
+
+  // Appends the instructions of a table, referring to tables and unions by
+  // their number in "tables" and "unions".
+  void CompileTable(const Parser &parser, const StructDef &struct_def,
+                    const std::map<const StructDef *, uint32_t> &tables,
+                    const std::map<const EnumDef *, uint32_t> &unions);
+  bool VerifyTable(Verifier &verifier, const Table *table, uint32_t pc) const;
+
+  std::vector<Instruction> program_;
+  // For each union, where the instructions for each of its types start
+  // (0xFFFFFFFF if the type is unknown).
+  std::vector<std::vector<uint32_t>> unions_;
+  uint32_t root_;
+};
+
 // Utility functions for multiple generators:
 
 extern std::string MakeCamel(const std::string &in, bool first = true);
@@ -391,6 +464,7 @@ struct GeneratorOptions {
   bool prefixed_enums;
   bool include_dependence_headers;
   bool numeric_json;
+  bool generate_views;
 
   // Possible options for the more general generator below.
   enum Language { kJava, kCSharp, kMAX };
@@ -400,7 +474,7 @@ struct GeneratorOptions {
   GeneratorOptions() : strict_json(false), indent_step(2),
                        output_enum_identifiers(true), prefixed_enums(true),
                        include_dependence_headers(false),
-                       numeric_json(false),
+                       numeric_json(false), generate_views(false),
                        lang(GeneratorOptions::kJava) {}
 };
 
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLATBUFFERS_LAZY_VERIFIER_H_
+#define FLATBUFFERS_LAZY_VERIFIER_H_
+
+// Kept apart from flatbuffers.h, so only code that uses the XLazy views
+// (see flatc --gen-views) pays for including it.
+
+#include <unordered_set>
+
+#include "flatbuffers/flatbuffers.h"
+
+namespace flatbuffers {
+
+// Verifies a buffer as it is read rather than all up front, for when only
+// a small part of a large buffer will be read. Use it through the generated
+// XLazy views, e.g.:
+//   LazyVerifier verifier(buf, len);
+//   MonsterLazy monster(verifier.GetRoot<Monster>(), verifier);
+//   if (monster && monster.name()) ...
+// A table is checked the first time a view is made of it: its vtable and the
+// fields stored in it, but not what they point to. Strings, vectors, tables
+// and unions are checked when an accessor of the view reaches them (vectors
+// of strings and unions as a whole), and the view accessors return nullptr
+// (or an empty view) for anything that didn't verify. What has been checked
+// is remembered, so reading it again is cheap (except for unions, which are
+// checked on every access).
+// The depth limit of Verifier doesn't apply, since nothing is recursed into,
+// but the table limit does.
+class LazyVerifier FLATBUFFERS_FINAL_CLASS {
+ public:
+  LazyVerifier(const uint8_t *buf, size_t buf_len,
+               size_t _max_tables = 1000000)
+    : buf_(buf), verifier_(buf, buf_len, 64, _max_tables), ok_(true) {}
+
+  // The root table, or nullptr if it doesn't verify.
+  template<typename T> const T *GetRoot() {
+    if (!Check(verifier_.Verify<uoffset_t>(buf_))) return nullptr;
+    return VerifyTable(flatbuffers::GetRoot<T>(buf_));
+  }
+
+  // Each of these returns its argument if it verifies, or nullptr if not.
+  template<typename T> const T *VerifyTable(const T *table) {
+    return Memoize(table, TypeTag<T>(),
+                   [&]() { return table->VerifyShallow(verifier_); });
+  }
+
+  const String *VerifyString(const String *str) {
+    return Memoize(str, TypeTag<String>(),
+                   [&]() { return verifier_.Verify(str); });
+  }
+
+  template<typename T> const Vector<T> *VerifyVector(const Vector<T> *vec) {
+    return Memoize(vec, TypeTag<Vector<T>>(),
+                   [&]() { return verifier_.Verify(vec); });
+  }
+
+  const Vector<Offset<String>> *VerifyVectorOfStrings(
+                                  const Vector<Offset<String>> *vec) {
+    // Tagged apart from the same vector having been verified by itself.
+    return Memoize(vec, TypeTag<String *>(), [&]() {
+      return verifier_.Verify(vec) && verifier_.VerifyVectorOfStrings(vec);
+    });
+  }
+
+  // Checks a union member with the generated VerifyX() function of its
+  // union, which verifies all of it the first time it is read as this type.
+  template<typename E> const void *VerifyUnion(
+                         const void *union_obj, E type,
+                         bool (*verify)(Verifier &, const void *, E)) {
+    return Memoize(union_obj, TypeTag<E>(),
+                   [&]() { return verify(verifier_, union_obj, type); },
+                   static_cast<size_t>(type));
+  }
+
+  // false once anything failed to verify.
+  bool ok() const { return ok_; }
+
+ private:
+  // An object, the type it was verified as, and for unions the type field.
+  struct Key {
+    const void *obj;
+    const void *tag;
+    size_t sub;
+
+    bool operator==(const Key &o) const {
+      return obj == o.obj && tag == o.tag && sub == o.sub;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key &key) const {
+      return std::hash<const void *>()(key.obj) ^
+             std::hash<const void *>()(key.tag) ^ key.sub;
+    }
+  };
+
+  // A unique address per type, to tell apart objects of different types at
+  // the same location (in a malformed buffer).
+  template<typename T> static const void *TypeTag() {
+    static const char tag = 0;
+    return &tag;
+  }
+
+  bool Check(bool ok) {
+    if (!ok) ok_ = false;
+    return ok;
+  }
+
+  template<typename T, typename F> const T *Memoize(const T *obj,
+                                                    const void *tag,
+                                                    F verify,
+                                                    size_t sub = 0) {
+    if (!obj) return nullptr;
+    Key key = { obj, tag, sub };
+    if (verified_.count(key)) return obj;
+    if (!Check(verify())) return nullptr;
+    verified_.insert(key);
+    return obj;
+  }
+
+  const uint8_t *buf_;
+  Verifier verifier_;
+  bool ok_;
+  std::unordered_set<Key, KeyHash> verified_;
+};
+
+// A vector of tables read through a LazyVerifier, L being the generated
+// lazy view of T. Elements are verified as they are accessed.
+template<typename T, typename L> class LazyVector {
+ public:
+  LazyVector(const Vector<Offset<T>> *vec, LazyVerifier &verifier)
+    : vec_(verifier.VerifyVector(vec)), verifier_(&verifier) {}
+
+  // nullptr if the vector is absent or didn't verify.
+  const Vector<Offset<T>> *get() const { return vec_; }
+  uoffset_t size() const { return vec_ ? vec_->size() : 0; }
+  L Get(uoffset_t i) const { return L(vec_->Get(i), *verifier_); }
+
+ private:
+  const Vector<Offset<T>> *vec_;
+  LazyVerifier *verifier_;
+};
+
+}  // namespace flatbuffers
+
+#endif  // FLATBUFFERS_LAZY_VERIFIER_H_
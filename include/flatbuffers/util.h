@@ -23,6 +23,10 @@
 #include <sstream>
 #include <stdlib.h>
 #include <assert.h>
+#include <new>
+#include <chrono>
+#include <system_error>
+#include <thread>
 #ifdef _WIN32
 #ifndef WIN32_LEAN_AND_MEAN
   #define WIN32_LEAN_AND_MEAN
@@ -35,9 +39,16 @@
 #include <direct.h>
 #else
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #endif
 
+#include "flatbuffers/flatbuffers.h"
+
 namespace flatbuffers {
 
 // Convert an integer or floating point value to a string.
@@ -92,6 +103,113 @@ inline bool LoadFile(const char *name, bool binary, std::string *buf) {
   return !ifs.bad();
 }
 
+// Nanoseconds on a clock that never goes back, for Verifier::MeasureTime().
+inline uint64_t NowNanoseconds() {
+  return static_cast<uint64_t>(
+           std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Runs job(context, i) for each i below num_jobs, each on a thread of its
+// own except for the last, which runs on the calling thread. Jobs that no
+// thread could be started for also run on the calling thread. For
+// Verifier::UseThreads(), and needs linking with -pthread on some platforms.
+inline void RunOnThreads(size_t num_jobs, void (*job)(void *context, size_t i),
+                         void *context) {
+  if (!num_jobs) return;
+  std::vector<std::thread> threads;
+  threads.reserve(num_jobs - 1);
+  for (size_t i = 0; i + 1 < num_jobs; i++) {
+    try {
+      threads.push_back(std::thread(job, context, i));
+    } catch (const std::system_error &) {
+      job(context, i);
+    }
+  }
+  job(context, num_jobs - 1);
+  for (auto it = threads.begin(); it != threads.end(); ++it) it->join();
+}
+
+// A file opened read-only for as long as this object lives, memory mapped
+// where possible, so large binary files can be read (e.g. with GetRoot())
+// or verified in place without copying them to the heap first.
+// Where files can't be mapped, they are read into memory instead. Either
+// way, data() is aligned for any scalar, as reading a buffer requires.
+class MappedFile {
+ public:
+  // How the file will be read, given as a hint to the OS.
+  enum Access { kAccessNormal, kAccessSequential, kAccessRandom };
+
+  MappedFile() : data_(nullptr), size_(0), mapped_(false) {}
+  explicit MappedFile(const char *name, Access access = kAccessNormal)
+    : data_(nullptr), size_(0), mapped_(false) {
+    Open(name, access);
+  }
+  ~MappedFile() { Close(); }
+
+  // Opens file "name", closing any file opened before. Returns false if it
+  // couldn't be read.
+  bool Open(const char *name, Access access = kAccessNormal) {
+    Close();
+    #ifndef _WIN32
+      auto fd = open(name, O_RDONLY);
+      if (fd < 0) return false;
+      struct stat st;
+      bool ok = fstat(fd, &st) == 0;
+      if (ok && S_ISREG(st.st_mode) && st.st_size > 0) {
+        auto size = static_cast<size_t>(st.st_size);
+        auto p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+          if (access != kAccessNormal)
+            madvise(p, size, access == kAccessSequential ? MADV_SEQUENTIAL
+                                                         : MADV_RANDOM);
+          data_ = reinterpret_cast<const uint8_t *>(p);
+          size_ = size;
+          mapped_ = true;
+        }
+      }
+      close(fd);
+      if (!ok) return false;
+      if (mapped_) return true;
+    #else
+      (void)access;
+    #endif
+    // Not a regular file (e.g. a pipe), empty, or mapping failed.
+    std::string contents;
+    if (!LoadFile(name, true, &contents)) return false;
+    copy_.resize((contents.size() + sizeof(largest_scalar_t) - 1) /
+                 sizeof(largest_scalar_t));
+    if (!contents.empty()) memcpy(copy_.data(), contents.data(),
+                                  contents.size());
+    data_ = reinterpret_cast<const uint8_t *>(copy_.data());
+    size_ = contents.size();
+    return true;
+  }
+
+  void Close() {
+    #ifndef _WIN32
+      if (mapped_) munmap(const_cast<uint8_t *>(data_), size_);
+    #endif
+    copy_.clear();
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+  }
+
+  const uint8_t *data() const { return data_; }
+  size_t size() const { return size_; }
+  bool mapped() const { return mapped_; }
+
+ private:
+  MappedFile(const MappedFile &);
+  MappedFile &operator=(const MappedFile &);
+
+  const uint8_t *data_;
+  size_t size_;
+  bool mapped_;
+  std::vector<largest_scalar_t> copy_;
+};
+
 // Save data "buf" of length "len" bytes into a file
 // "name" returning true if successful, false otherwise.
 // If "binary" is false data is written using ifstream's
@@ -113,6 +231,56 @@ inline bool SaveFile(const char *name, const std::string &buf, bool binary) {
   return SaveFile(name, buf.c_str(), buf.size(), binary);
 }
 
+// Save a buffer given as segments (see
+// FlatBufferBuilder::GetBufferSegments()) into file "name", without
+// gathering it into one block first.
+inline bool SaveFile(const char *name,
+                     const std::vector<BufferSegment> &segments) {
+  std::ofstream ofs(name, std::ofstream::binary);
+  if (!ofs.is_open()) return false;
+  for (auto it = segments.begin(); it != segments.end(); ++it) {
+    ofs.write(reinterpret_cast<const char *>(it->data), it->size);
+  }
+  return !ofs.bad();
+}
+
+#ifndef _WIN32
+// Write a buffer given as segments to a file descriptor (a file, pipe or
+// socket) with writev(). Returns false on error, with errno set.
+inline bool WriteBufferSegments(int fd,
+                                const std::vector<BufferSegment> &segments) {
+  #ifdef IOV_MAX
+    const size_t kMaxIovecs = IOV_MAX;
+  #else
+    const size_t kMaxIovecs = 16;
+  #endif
+  std::vector<iovec> iov(segments.size());
+  for (size_t i = 0; i < segments.size(); i++) {
+    iov[i].iov_base = const_cast<uint8_t *>(segments[i].data);
+    iov[i].iov_len = segments[i].size;
+  }
+  size_t first = 0;
+  while (first < iov.size()) {
+    auto count = std::min(iov.size() - first, kMaxIovecs);
+    auto written = writev(fd, &iov[first], static_cast<int>(count));
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    // Skip what was written, which may end halfway through a segment.
+    auto left = static_cast<size_t>(written);
+    while (first < iov.size() && left >= iov[first].iov_len) {
+      left -= iov[first++].iov_len;
+    }
+    if (left) {
+      iov[first].iov_base = static_cast<uint8_t *>(iov[first].iov_base) + left;
+      iov[first].iov_len -= left;
+    }
+  }
+  return true;
+}
+#endif  // !_WIN32
+
 // Functionality for minimalistic portable path handling:
 
 static const char kPosixPathSeparator = '/';
@@ -180,6 +348,74 @@ inline std::string AbsolutePath(const std::string &filepath) {
     : filepath;
 }
 
+#ifdef __linux__
+// Allocator that maps memory directly from the OS, for builders of large
+// buffers. Growing a block moves its pages to the top of a bigger mapping
+// with mremap(), so the data already written is never copied.
+// Every block takes up at least one page.
+class mmap_allocator : public simple_allocator {
+ public:
+  uint8_t *allocate(size_t size) const {
+    auto length = MappingLength(size);
+    return Place(Map(length), length, size);
+  }
+
+  void deallocate(uint8_t *p) const {
+    auto header = Header(p);
+    munmap(header->base, header->length);
+  }
+
+  uint8_t *reallocate_downward(uint8_t *p, size_t /*old_size*/,
+                               size_t new_size, size_t /*in_use*/) const {
+    auto old_header = *Header(p);
+    auto length = MappingLength(new_size);
+    auto base = Map(length);
+    // The old block ends at the end of its mapping, so moving the whole
+    // mapping to the end of the new one keeps the data at the top.
+    auto moved = mremap(old_header.base, old_header.length, old_header.length,
+                        MREMAP_MAYMOVE | MREMAP_FIXED,
+                        base + length - old_header.length);
+    if (moved == MAP_FAILED) {
+      munmap(base, length);
+      throw std::bad_alloc();
+    }
+    return Place(base, length, new_size);
+  }
+
+ private:
+  // Stored just below each block, to find the mapping it belongs to.
+  struct MappingHeader {
+    uint8_t *base;
+    size_t length;
+  };
+
+  static MappingHeader *Header(uint8_t *p) {
+    return reinterpret_cast<MappingHeader *>(p) - 1;
+  }
+
+  static size_t MappingLength(size_t size) {
+    auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return (size + sizeof(MappingHeader) + page - 1) & ~(page - 1);
+  }
+
+  static uint8_t *Map(size_t length) {
+    auto base = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) throw std::bad_alloc();
+    return reinterpret_cast<uint8_t *>(base);
+  }
+
+  // Blocks are placed at the end of their mapping.
+  static uint8_t *Place(uint8_t *base, size_t length, size_t size) {
+    auto p = base + length - size;
+    auto header = Header(p);
+    header->base = base;
+    header->length = length;
+    return p;
+  }
+};
+#endif  // __linux__
+
 // To and from UTF-8 unicode conversion functions
 
 // Convert a unicode code point into a UTF-8 representation by appending it
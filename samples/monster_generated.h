@@ -60,8 +60,19 @@ struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   int16_t mana() const { return GetField<int16_t>(6, 150); }
   int16_t hp() const { return GetField<int16_t>(8, 100); }
   const flatbuffers::String *name() const { return GetPointer<const flatbuffers::String *>(10); }
+  flatbuffers::string_view name_view() const { auto s = name(); return s ? s->str_view() : flatbuffers::string_view(); }
   const flatbuffers::Vector<uint8_t> *inventory() const { return GetPointer<const flatbuffers::Vector<uint8_t> *>(14); }
   Color color() const { return static_cast<Color>(GetField<int8_t>(16, 2)); }
+  enum : uint64_t {
+    Present_pos = 1ULL << 0,
+    Present_mana = 1ULL << 1,
+    Present_hp = 1ULL << 2,
+    Present_name = 1ULL << 3,
+    Present_inventory = 1ULL << 5,
+    Present_color = 1ULL << 6,
+    RequiredFields = 0
+  };
+  uint64_t PresentFields() const { return PresentFieldBits(0, 7); }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<Vec3>(verifier, 4 /* pos */) &&
@@ -85,6 +96,9 @@ struct MonsterBuilder {
   void add_name(flatbuffers::Offset<flatbuffers::String> name) { fbb_.AddOffset(10, name); }
   void add_inventory(flatbuffers::Offset<flatbuffers::Vector<uint8_t>> inventory) { fbb_.AddOffset(14, inventory); }
   void add_color(Color color) { fbb_.AddElement<int8_t>(16, static_cast<int8_t>(color), 2); }
+  // Upper bound on the size of one Monster (not counting what it refers to),
+  // e.g. for FlatBufferBuilder::Reserve().
+  enum { kInlineSizeEstimate = 64 };
   MonsterBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) { start_ = fbb_.StartTable(); }
   MonsterBuilder &operator=(const MonsterBuilder &);
   flatbuffers::Offset<Monster> Finish() {
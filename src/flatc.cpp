@@ -23,16 +23,33 @@ static void Error(const char *err, const char *obj = nullptr,
 
 namespace flatbuffers {
 
+// A binary file being converted (one listed after --). The generators read
+// it straight from its mapping, rather than from the parser's builder, which
+// holds the output of parsing JSON.
+static MappedFile binary_input;
+static bool binary_input_open = false;
+
+static const uint8_t *GetOutputBuffer(const Parser &parser, size_t *size) {
+  if (binary_input_open) {
+    *size = binary_input.size();
+    return binary_input.data();
+  }
+  *size = parser.builder_.GetSize();
+  return parser.builder_.GetBufferPointer();
+}
+
 bool GenerateBinary(const Parser &parser,
                     const std::string &path,
                     const std::string &file_name,
                     const GeneratorOptions & /*opts*/) {
   auto ext = parser.file_extension_.length() ? parser.file_extension_ : "bin";
-  return !parser.builder_.GetSize() ||
+  size_t size;
+  auto buf = GetOutputBuffer(parser, &size);
+  return !size ||
          flatbuffers::SaveFile(
            (path + file_name + "." + ext).c_str(),
-           reinterpret_cast<char *>(parser.builder_.GetBufferPointer()),
-           parser.builder_.GetSize(),
+           reinterpret_cast<const char *>(buf),
+           size,
            true);
 }
 
@@ -40,11 +57,12 @@ bool GenerateTextFile(const Parser &parser,
                       const std::string &path,
                       const std::string &file_name,
                       const GeneratorOptions &opts) {
-  if (!parser.builder_.GetSize()) return true;
+  size_t size;
+  auto buf = GetOutputBuffer(parser, &size);
+  if (!size) return true;
   if (!parser.root_struct_def) Error("root_type not set");
   std::string text;
-  GenerateText(parser, parser.builder_.GetBufferPointer(), opts,
-               &text);
+  GenerateText(parser, buf, opts, &text);
   return flatbuffers::SaveFile((path + file_name + ".json").c_str(),
                                text,
                                false);
@@ -106,6 +124,8 @@ static void Error(const char *err, const char *obj, bool usage,
       "  --no-prefix     Don\'t prefix enum values with the enum type in C++.\n"
       "  --gen-includes  Generate include statements for included schemas the\n"
       "                  generated file depends on (C++).\n"
+      "  --gen-views     Generate the XView, XFields and XLazy classes for\n"
+      "                  tables (C++).\n"
       "  --proto         Input is a .proto, translate to .fbs.\n"
       "FILEs may depend on declarations in earlier files.\n"
       "FILEs after the -- must be binary flatbuffer format files.\n"
@@ -146,6 +166,8 @@ int main(int argc, const char *argv[]) {
         opts.prefixed_enums = false;
       } else if(opt == "--gen-includes") {
         opts.include_dependence_headers = true;
+      } else if(opt == "--gen-views") {
+        opts.generate_views = true;
       } else if(opt == "--") {  // Separator between text and binary inputs.
         binary_files_from = filenames.size();
       } else if(opt == "--proto") {
@@ -178,18 +200,26 @@ int main(int argc, const char *argv[]) {
   for (auto file_it = filenames.begin();
             file_it != filenames.end();
           ++file_it) {
-      std::string contents;
-      if (!flatbuffers::LoadFile(file_it->c_str(), true, &contents))
-        Error("unable to load file", file_it->c_str());
-
       bool is_binary = static_cast<size_t>(file_it - filenames.begin()) >=
                        binary_files_from;
+      auto &file = flatbuffers::binary_input;
+      flatbuffers::binary_input_open = is_binary;
       if (is_binary) {
-        parser.builder_.Clear();
-        parser.builder_.PushBytes(
-          reinterpret_cast<const uint8_t *>(contents.c_str()),
-          contents.length());
+        // Read by the generators straight from the mapping, without copying.
+        if (!file.Open(file_it->c_str(),
+                       flatbuffers::MappedFile::kAccessSequential))
+          Error("unable to load file", file_it->c_str());
+        // The generators trust the buffer, so check it against the schema
+        // first. They skip empty files.
+        if (file.size() && parser.root_struct_def &&
+            !flatbuffers::SchemaVerifier(parser).Verify(file.data(),
+                                                        file.size()))
+          Error("binary file doesn't match the schema", file_it->c_str());
       } else {
+        file.Close();
+        std::string contents;
+        if (!flatbuffers::LoadFile(file_it->c_str(), true, &contents))
+          Error("unable to load file", file_it->c_str());
         auto local_include_directory = flatbuffers::StripFileName(*file_it);
         include_directories.push_back(local_include_directory.c_str());
         include_directories.push_back(nullptr);
@@ -199,6 +199,315 @@ std::string GenUnderlyingCast(const Parser &parser, const FieldDef &field,
       : val;
 }
 
+// A conservative estimate of the bytes a table takes up in a buffer: its
+// vtable, its fields and any padding between them, but not the strings,
+// vectors and tables it refers to.
+static size_t InlineSizeEstimate(const StructDef &struct_def) {
+  auto size = sizeof(voffset_t) * (2 + struct_def.fields.vec.size()) +
+              sizeof(soffset_t) * 2 - 1;
+  size_t max_align = sizeof(soffset_t);
+  for (auto it = struct_def.fields.vec.begin();
+       it != struct_def.fields.vec.end();
+       ++it) {
+    auto &field = **it;
+    if (!field.deprecated) {
+      auto align = InlineAlignment(field.value.type);
+      size += InlineSize(field.value.type) + align - 1;
+      max_align = std::max(max_align, align);
+    }
+  }
+  return size + max_align - 1;
+}
+
+// Where each field of a fixed_layout table goes, relative to the start of
+// the table (which holds the vtable offset). At each point we place the most
+// aligned field that needs no padding there, so there is hardly any.
+// Deprecated fields get offset 0. Returns the size of the table.
+static size_t FixedTableLayout(const StructDef &struct_def,
+                               std::vector<size_t> *field_offsets,
+                               size_t *alignment) {
+  auto &fields = struct_def.fields.vec;
+  std::vector<size_t> left;
+  for (size_t i = 0; i < fields.size(); i++) {
+    if (!fields[i]->deprecated) left.push_back(i);
+  }
+  field_offsets->assign(fields.size(), 0);
+  size_t size = sizeof(soffset_t);
+  *alignment = sizeof(soffset_t);
+  while (!left.empty()) {
+    auto best = left.end();
+    size_t min_align = sizeof(largest_scalar_t) * 256;
+    for (auto it = left.begin(); it != left.end(); ++it) {
+      auto align = InlineAlignment(fields[*it]->value.type);
+      min_align = std::min(min_align, align);
+      if (!PaddingBytes(size, align) &&
+          (best == left.end() ||
+           align > InlineAlignment(fields[*best]->value.type))) {
+        best = it;
+      }
+    }
+    if (best == left.end()) {
+      // Nothing fits here without padding.
+      size += PaddingBytes(size, min_align);
+      continue;
+    }
+    auto &type = fields[*best]->value.type;
+    (*field_offsets)[*best] = size;
+    size += InlineSize(type);
+    *alignment = std::max(*alignment, InlineAlignment(type));
+    left.erase(best);
+  }
+  return size;
+}
+
+// Generate a builder for tables with the fixed_layout attribute, which
+// writes all fields at once to precomputed places, sharing one vtable.
+static void GenFixedBuilder(const Parser &parser, StructDef &struct_def,
+                            std::string *code_ptr) {
+  std::string &code = *code_ptr;
+  auto &fields = struct_def.fields.vec;
+  std::vector<size_t> field_offsets;
+  size_t alignment;
+  auto size = NumToString(FixedTableLayout(struct_def, &field_offsets,
+                                           &alignment));
+  auto name = struct_def.name + "FixedBuilder";
+  code += "// Creates " + struct_def.name + " tables with all fields present";
+  code += " faster than Create" + struct_def.name + "(),\n";
+  code += "// since they all share one layout. The vtable is written again ";
+  code += "when the\n// builder was cleared.\n";
+  code += "struct " + name + " {\n";
+  code += "  flatbuffers::FlatBufferBuilder &fbb_;\n";
+  code += "  flatbuffers::uoffset_t vtable_;\n";
+  code += "  size_t clears_;\n";
+  code += "  " + name + "(flatbuffers::FlatBufferBuilder &_fbb) : ";
+  code += "fbb_(_fbb), vtable_(0), clears_(0) {}\n";
+  code += "  " + name + " &operator=(const " + name + " &);\n";
+  code += "  flatbuffers::Offset<" + struct_def.name + "> Create(";
+  std::string sep;
+  for (auto it = fields.begin(); it != fields.end(); ++it) {
+    auto &field = **it;
+    if (!field.deprecated) {
+      code += sep + GenTypeWire(parser, field.value.type, " ", true);
+      code += field.name;
+      sep = ", ";
+    }
+  }
+  code += ") {\n";
+  code += "    if (!vtable_ || clears_ != fbb_.GetClearCount()) {\n";
+  code += "      static const flatbuffers::voffset_t field_offsets[] = {";
+  sep = " ";
+  for (auto it = field_offsets.begin(); it != field_offsets.end(); ++it) {
+    code += sep + NumToString(*it);
+    sep = ", ";
+  }
+  code += " };\n";
+  code += "      vtable_ = fbb_.CreateVtable(field_offsets, ";
+  code += NumToString(fields.size()) + ", " + size + ");\n";
+  code += "      clears_ = fbb_.GetClearCount();\n    }\n";
+  code += "    auto table_ = fbb_.StartFixedTable(vtable_, " + size + ", ";
+  code += NumToString(alignment) + ");\n";
+  code += "    auto o_ = fbb_.GetSize();\n";
+  for (size_t i = 0; i < fields.size(); i++) {
+    auto &field = *fields[i];
+    if (field.deprecated) continue;
+    auto dest = "table_ + " + NumToString(field_offsets[i]);
+    if (IsScalar(field.value.type.base_type)) {
+      code += "    flatbuffers::WriteScalar<";
+      code += GenTypeWire(parser, field.value.type, "", false) + ">(";
+      code += dest + ", " + GenUnderlyingCast(parser, field, false, field.name);
+      code += ");\n";
+    } else if (IsStruct(field.value.type)) {
+      code += "    assert(" + field.name + ");\n";
+      code += "    memcpy(" + dest + ", " + field.name + ", sizeof(*";
+      code += field.name + "));\n";
+    } else {
+      code += "    assert(" + field.name + ".o);\n";
+      code += "    flatbuffers::WriteScalar<flatbuffers::uoffset_t>(" + dest;
+      code += ", o_ - " + NumToString(field_offsets[i]) + " - " + field.name;
+      code += ".o);\n";
+    }
+  }
+  code += "    return flatbuffers::Offset<" + struct_def.name + ">(o_);\n";
+  code += "  }\n};\n\n";
+}
+
+// Generate an accessor of the form:
+// type name() const { return GetField<type>(offset, defaultval); }
+static void GenFieldGetter(const Parser &parser, const FieldDef &field,
+                           std::string *code_ptr) {
+  std::string &code = *code_ptr;
+  code += "  " + GenTypeGet(parser, field.value.type, " ", "const ", " *",
+                            true);
+  code += field.name + "() const { return ";
+  // Call a different accessor for pointers, that indirects.
+  std::string call = IsScalar(field.value.type.base_type)
+    ? "GetField<"
+    : (IsStruct(field.value.type) ? "GetStruct<" : "GetPointer<");
+  call += GenTypeGet(parser, field.value.type, "", "const ", " *", false);
+  call += ">(" + NumToString(field.value.offset);
+  // Default value as second arg for non-pointer types.
+  if (IsScalar(field.value.type.base_type))
+    call += ", " + field.value.constant;
+  call += ")";
+  code += GenUnderlyingCast(parser, field, true, call);
+  code += "; }\n";
+  // Strings can also be read without a copy or a null check.
+  if (field.value.type.base_type == BASE_TYPE_STRING) {
+    code += "  flatbuffers::string_view " + field.name + "_view() const { ";
+    code += "auto s = " + field.name + "(); ";
+    code += "return s ? s->str_view() : flatbuffers::string_view(); }\n";
+  }
+}
+
+// Generate a view that reads a table through a flatbuffers::LazyVerifier,
+// verifying what its accessors reach. Accessors that return the views of
+// other tables are defined in code_post, after all views are declared.
+static void GenLazyView(const Parser &parser, StructDef &struct_def,
+                        std::string *code_ptr, std::string *code_post_ptr) {
+  std::string &code = *code_ptr;
+  std::string &code_post = *code_post_ptr;
+  auto name = struct_def.name + "Lazy";
+  code += "// Reads a " + struct_def.name + " from a buffer checked by a ";
+  code += "flatbuffers::LazyVerifier.\n";
+  code += "struct " + name + " FLATBUFFERS_FINAL_CLASS {\n";
+  code += "  " + name + "(const " + struct_def.name + " *table, ";
+  code += "flatbuffers::LazyVerifier &verifier)\n";
+  code += "    : table_(verifier.VerifyTable(table)), verifier_(&verifier) {}\n";
+  code += "  // nullptr if absent or it didn't verify.\n";
+  code += "  const " + struct_def.name + " *get() const { return table_; }\n";
+  code += "  explicit operator bool() const { return table_ != nullptr; }\n";
+  for (auto it = struct_def.fields.vec.begin();
+       it != struct_def.fields.vec.end();
+       ++it) {
+    auto &field = **it;
+    if (field.deprecated) continue;
+    auto &type = field.value.type;
+    auto getter = "table_->" + field.name + "()";
+    // Tables and vectors of them are returned as lazy views.
+    const StructDef *table_def = nullptr;
+    if (type.base_type == BASE_TYPE_STRUCT && !type.struct_def->fixed) {
+      table_def = type.struct_def;
+    } else if (type.base_type == BASE_TYPE_VECTOR &&
+               type.element == BASE_TYPE_STRUCT && !type.struct_def->fixed) {
+      table_def = type.struct_def;
+    }
+    if (table_def) {
+      auto lazy_type = WrapInNameSpace(parser, table_def->defined_namespace,
+                                       table_def->name + "Lazy");
+      if (type.base_type == BASE_TYPE_VECTOR) {
+        lazy_type = "flatbuffers::LazyVector<" +
+                    WrapInNameSpace(parser, table_def->defined_namespace,
+                                    table_def->name) + ", " + lazy_type + ">";
+      }
+      code += "  " + lazy_type + " " + field.name + "() const;\n";
+      code_post += "inline " + lazy_type + " " + name + "::" + field.name;
+      code_post += "() const { return " + lazy_type + "(" + getter;
+      code_post += ", *verifier_); }\n\n";
+      continue;
+    }
+    code += "  " + GenTypeGet(parser, type, " ", "const ", " *", true);
+    code += field.name + "() const { return ";
+    switch (type.base_type) {
+      case BASE_TYPE_STRING:
+        code += "verifier_->VerifyString(" + getter + ")";
+        break;
+      case BASE_TYPE_VECTOR:
+        code += type.element == BASE_TYPE_STRING
+          ? "verifier_->VerifyVectorOfStrings("
+          : "verifier_->VerifyVector(";
+        code += getter + ")";
+        break;
+      case BASE_TYPE_UNION:
+        code += "verifier_->VerifyUnion(" + getter + ", table_->";
+        code += field.name + "_type(), ";
+        code += WrapInNameSpace(parser, type.enum_def->defined_namespace,
+                                "Verify" + type.enum_def->name) + ")";
+        break;
+      default:  // Scalars and structs were checked with the table.
+        code += getter;
+        break;
+    }
+    code += "; }\n";
+  }
+  code += " private:\n";
+  code += "  const " + struct_def.name + " *table_;\n";
+  code += "  flatbuffers::LazyVerifier *verifier_;\n";
+  code += "};\n\n";
+}
+
+// The number of field ids of a table, i.e. its highest id + 1.
+static size_t NumFieldIds(const StructDef &struct_def) {
+  size_t num_field_ids = 0;
+  for (auto it = struct_def.fields.vec.begin();
+       it != struct_def.fields.vec.end();
+       ++it) {
+    auto id = ((*it)->value.offset - 2 * sizeof(voffset_t)) / sizeof(voffset_t);
+    num_field_ids = std::max(num_field_ids, id + 1);
+  }
+  return num_field_ids;
+}
+
+// Generate a verifier function that checks only the table itself and its
+// fields, not what they point to, for flatbuffers::LazyVerifier.
+static void GenVerifyShallow(const Parser &parser, const StructDef &struct_def,
+                             std::string *code_ptr) {
+  std::string &code = *code_ptr;
+  std::string prefix = " &&\n           ";
+  code += "  bool VerifyShallow(flatbuffers::Verifier &verifier) const {\n";
+  code += "    return VerifyTableStart(verifier)";
+  for (auto it = struct_def.fields.vec.begin();
+       it != struct_def.fields.vec.end();
+       ++it) {
+    auto &field = **it;
+    if (field.deprecated) continue;
+    code += prefix + "VerifyField";
+    if (field.required) code += "Required";
+    code += "<" + GenTypeSize(parser, field.value.type);
+    code += ">(verifier, " + NumToString(field.value.offset);
+    code += " /* " + field.name + " */)";
+  }
+  code += prefix + "verifier.EndTable()";
+  code += ";\n  }\n";
+}
+
+// Generate a view with the same accessors as the table, that looks up the
+// vtable only once, and a descriptor for each scalar field, for use with
+// flatbuffers::ExtractColumn().
+static void GenViews(const Parser &parser, const StructDef &struct_def,
+                     std::string *code_ptr) {
+  std::string &code = *code_ptr;
+  code += "// Reads many fields of one " + struct_def.name;
+  code += " faster, use as a local variable.\n";
+  code += "struct " + struct_def.name + "View FLATBUFFERS_FINAL_CLASS";
+  code += " : private flatbuffers::TableView {\n";
+  code += "  explicit " + struct_def.name + "View(const " + struct_def.name;
+  code += " *table) : flatbuffers::TableView(table) {}\n";
+  for (auto it = struct_def.fields.vec.begin();
+       it != struct_def.fields.vec.end();
+       ++it) {
+    auto &field = **it;
+    if (!field.deprecated) GenFieldGetter(parser, field, code_ptr);
+  }
+  code += "};\n\n";
+
+  code += "struct " + struct_def.name + "Fields {\n";
+  for (auto it = struct_def.fields.vec.begin();
+       it != struct_def.fields.vec.end();
+       ++it) {
+    auto &field = **it;
+    if (field.deprecated || !IsScalar(field.value.type.base_type)) continue;
+    auto type = GenTypeBasic(parser, field.value.type, false);
+    code += "  struct " + field.name + " {\n";
+    code += "    typedef " + struct_def.name + " table_type;\n";
+    code += "    typedef " + type + " value_type;\n";
+    code += "    enum { offset = " + NumToString(field.value.offset) + " };\n";
+    code += "    static " + type + " default_value() { return ";
+    code += field.value.constant + "; }\n";
+    code += "  };\n";
+  }
+  code += "};\n\n";
+}
+
 // Generate an accessor struct, builder structs & function for a table.
 static void GenTable(const Parser &parser, StructDef &struct_def,
                      const GeneratorOptions &opts, std::string *code_ptr) {
@@ -217,36 +526,116 @@ static void GenTable(const Parser &parser, StructDef &struct_def,
     auto &field = **it;
     if (!field.deprecated) {  // Deprecated fields won't be accessible.
       GenComment(field.doc_comment, code_ptr, "  ");
-      code += "  " + GenTypeGet(parser, field.value.type, " ", "const ", " *",
-                                true);
-      code += field.name + "() const { return ";
-      // Call a different accessor for pointers, that indirects.
-      std::string call = IsScalar(field.value.type.base_type)
-        ? "GetField<"
-        : (IsStruct(field.value.type) ? "GetStruct<" : "GetPointer<");
-      call += GenTypeGet(parser, field.value.type, "", "const ", " *", false);
-      call += ">(" + NumToString(field.value.offset);
-      // Default value as second arg for non-pointer types.
-      if (IsScalar(field.value.type.base_type))
-        call += ", " + field.value.constant;
-      call += ")";
-      code += GenUnderlyingCast(parser, field, true, call);
-      code += "; }\n";
+      GenFieldGetter(parser, field, code_ptr);
       auto nested = field.attributes.Lookup("nested_flatbuffer");
       if (nested) {
         auto nested_root = parser.structs_.Lookup(nested->constant);
         assert(nested_root);  // Guaranteed to exist by parser.
         code += "  const " + nested_root->name + " *" + field.name;
-        code += "_nested_root() { return flatbuffers::GetRoot<";
-        code += nested_root->name + ">(" + field.name + "()->Data()); }\n";
+        code += "_nested_root() const { return flatbuffers::GetNestedRoot<";
+        code += nested_root->name + ">(" + field.name + "()); }\n";
+        code += "  const " + nested_root->name + " *" + field.name;
+        code += "_verified_nested_root() const { return ";
+        code += "flatbuffers::GetVerifiedNestedRoot<" + nested_root->name;
+        code += ">(" + field.name + "()); }\n";
       }
     }
   }
+  // Generate PresentFields(), and for tables with at most 64 fields, a
+  // constant for the bit of each field in its result.
+  auto num_field_ids = NumFieldIds(struct_def);
+  if (num_field_ids <= 64) {
+    code += "  enum : uint64_t {\n";
+    std::string required = "0";
+    for (auto it = struct_def.fields.vec.begin();
+         it != struct_def.fields.vec.end();
+         ++it) {
+      auto &field = **it;
+      if (field.deprecated) continue;
+      auto id = (field.value.offset - 2 * sizeof(voffset_t)) /
+                sizeof(voffset_t);
+      code += "    Present_" + field.name + " = 1ULL << " + NumToString(id);
+      code += ",\n";
+      if (field.required) {
+        required = required == "0" ? "" : required + " | ";
+        required += "Present_" + field.name;
+      }
+    }
+    code += "    RequiredFields = " + required + "\n";
+    code += "  };\n";
+    code += "  uint64_t PresentFields() const { return PresentFieldBits(0, ";
+    code += NumToString(num_field_ids) + "); }\n";
+  } else {
+    auto bitset = "std::bitset<" + NumToString(num_field_ids) + ">";
+    code += "  " + bitset + " PresentFields() const { return ";
+    code += "Table::PresentFields<" + bitset + " >(); }\n";
+  }
+  // Generate functions to compare tables by their key, for sorting vectors
+  // of them and searching them with Vector::LookupByKey().
+  for (auto it = struct_def.fields.vec.begin();
+       it != struct_def.fields.vec.end();
+       ++it) {
+    auto &field = **it;
+    if (field.key) {
+      auto is_string = field.value.type.base_type == BASE_TYPE_STRING;
+      code += "  bool KeyCompareLessThan(const " + struct_def.name;
+      code += " *o) const { return ";
+      if (is_string) code += "*";
+      code += field.name + "() < ";
+      if (is_string) code += "*";
+      code += "o->" + field.name + "(); }\n";
+      auto key_type = is_string
+        ? std::string("const char *")
+        : GenTypeGet(parser, field.value.type, " ", "const ", " *", true);
+      code += "  int KeyCompareWithValue(" + key_type;
+      if (is_string) {
+        code += "_key) const { return " + field.name;
+        code += "()->compare(_key); }\n";
+      } else {
+        code += "_key) const { return static_cast<int>(" + field.name;
+        code += "() > _key) - static_cast<int>(" + field.name;
+        code += "() < _key); }\n";
+      }
+      // Hashes for hash indices must match what the parser computes, so
+      // enums are hashed as their underlying type.
+      auto hash = is_string ? "flatbuffers::HashString("
+                            : "flatbuffers::HashScalar(";
+      code += "  uint32_t KeyHash() const { return " + std::string(hash);
+      code += GenUnderlyingCast(parser, field, false, field.name + "()");
+      code += "); }\n";
+      code += "  static uint32_t KeyHash(" + key_type + "_key) { return ";
+      code += std::string(hash);
+      code += GenUnderlyingCast(parser, field, false, "_key") + "); }\n";
+    }
+  }
+  // Generate lookups through hash indices.
+  for (auto it = struct_def.fields.vec.begin();
+       it != struct_def.fields.vec.end();
+       ++it) {
+    auto &field = **it;
+    auto hash_index = field.attributes.Lookup("hash_index");
+    if (!hash_index || field.deprecated) continue;
+    auto vec = struct_def.fields.Lookup(hash_index->constant);
+    if (vec->deprecated) continue;
+    auto &elem = *vec->value.type.struct_def;
+    auto key = std::find_if(elem.fields.vec.begin(), elem.fields.vec.end(),
+                            [](const FieldDef *f) { return f->key; });
+    code += "  const " + WrapInNameSpace(parser, elem.defined_namespace,
+                                         elem.name);
+    code += " *" + vec->name + "_find(";
+    code += (*key)->value.type.base_type == BASE_TYPE_STRING
+      ? std::string("const char *")
+      : GenTypeGet(parser, (*key)->value.type, " ", "const ", " *", true);
+    code += "_key) const { return flatbuffers::LookupByHashIndex(";
+    code += vec->name + "(), " + field.name + "(), _key); }\n";
+  }
   // Generate a verifier function that can check a buffer from an untrusted
   // source will never cause reads outside the buffer.
   code += "  bool Verify(flatbuffers::Verifier &verifier) const {\n";
   code += "    return VerifyTableStart(verifier)";
   std::string prefix = " &&\n           ";
+  // Hash indices are checked last, when the vectors they index were checked.
+  std::string hash_indices;
   for (auto it = struct_def.fields.vec.begin();
        it != struct_def.fields.vec.end();
        ++it) {
@@ -273,6 +662,17 @@ static void GenTable(const Parser &parser, StructDef &struct_def,
           break;
         case BASE_TYPE_VECTOR:
           code += prefix + "verifier.Verify(" + field.name + "())";
+          if (field.attributes.Lookup("nested_flatbuffer")) {
+            code += prefix + "verifier.VerifyNestedFlatBuffer<";
+            code += field.attributes.Lookup("nested_flatbuffer")->constant;
+            code += ">(" + field.name + "())";
+          }
+          if (field.attributes.Lookup("hash_index")) {
+            hash_indices += prefix + "verifier.VerifyHashIndex(" + field.name;
+            hash_indices += "(), ";
+            hash_indices += field.attributes.Lookup("hash_index")->constant;
+            hash_indices += "())";
+          }
           switch (field.value.type.element) {
             case BASE_TYPE_STRING: {
               code += prefix + "verifier.VerifyVectorOfStrings(" + field.name;
@@ -295,10 +695,14 @@ static void GenTable(const Parser &parser, StructDef &struct_def,
       }
     }
   }
+  code += hash_indices;
   code += prefix + "verifier.EndTable()";
   code += ";\n  }\n";
+  if (opts.generate_views) GenVerifyShallow(parser, struct_def, code_ptr);
   code += "};\n\n";
 
+  if (opts.generate_views) GenViews(parser, struct_def, code_ptr);
+
   // Generate a builder struct, with methods of the form:
   // void add_name(type name) { fbb_.AddElement<type>(offset, name, default); }
   code += "struct " + struct_def.name;
@@ -327,6 +731,11 @@ static void GenTable(const Parser &parser, StructDef &struct_def,
       code += "); }\n";
     }
   }
+  code += "  // Upper bound on the size of one " + struct_def.name;
+  code += " (not counting what it refers to),\n";
+  code += "  // e.g. for FlatBufferBuilder::Reserve().\n";
+  code += "  enum { kInlineSizeEstimate = ";
+  code += NumToString(InlineSizeEstimate(struct_def)) + " };\n";
   code += "  " + struct_def.name;
   code += "Builder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) ";
   code += "{ start_ = fbb_.StartTable(); }\n";
@@ -391,6 +800,10 @@ static void GenTable(const Parser &parser, StructDef &struct_def,
     }
   }
   code += "  return builder_.Finish();\n}\n\n";
+
+  if (struct_def.attributes.Lookup("fixed_layout")) {
+    GenFixedBuilder(parser, struct_def, code_ptr);
+  }
 }
 
 static void GenPadding(const FieldDef &field, const std::function<void (int bits)> &f) {
@@ -529,6 +942,8 @@ std::string GenerateCPP(const Parser &parser,
        it != parser.structs_.vec.end(); ++it) {
     auto &struct_def = **it;
     auto decl = "struct " + struct_def.name + ";\n";
+    if (!struct_def.fixed && opts.generate_views)
+      decl += "struct " + struct_def.name + "Lazy;\n";
     if (struct_def.defined_namespace == parser.namespaces_.back()) {
       forward_decl_code_same_namespace += decl;
     } else {
@@ -555,14 +970,21 @@ std::string GenerateCPP(const Parser &parser,
   }
 
   // Generate code for all structs, then all tables.
-  std::string decl_code;
+  std::string decl_code, lazy_code_post;
+  bool wide_tables = false;
   for (auto it = parser.structs_.vec.begin();
        it != parser.structs_.vec.end(); ++it) {
     if ((**it).fixed) GenStruct(parser, **it, &decl_code);
   }
   for (auto it = parser.structs_.vec.begin();
        it != parser.structs_.vec.end(); ++it) {
-    if (!(**it).fixed) GenTable(parser, **it, opts, &decl_code);
+    if (!(**it).fixed) {
+      GenTable(parser, **it, opts, &decl_code);
+      if (opts.generate_views)
+        GenLazyView(parser, **it, &decl_code, &lazy_code_post);
+      // Their PresentFields() returns a std::bitset.
+      if (!(**it).generated && NumFieldIds(**it) > 64) wide_tables = true;
+    }
   }
 
   // Only output file-level code if there were any declarations.
@@ -593,7 +1015,11 @@ std::string GenerateCPP(const Parser &parser,
     code += "#ifndef " + include_guard + "\n";
     code += "#define " + include_guard + "\n\n";
 
-    code += "#include \"flatbuffers/flatbuffers.h\"\n\n";
+    code += "#include \"flatbuffers/flatbuffers.h\"\n";
+    if (opts.generate_views)
+      code += "#include \"flatbuffers/lazy_verifier.h\"\n";
+    if (wide_tables) code += "\n#include <bitset>\n";
+    code += "\n";
 
     if (opts.include_dependence_headers) {
       int num_includes = 0;
@@ -622,6 +1048,7 @@ std::string GenerateCPP(const Parser &parser,
     code += enum_code;
     code += decl_code;
     code += enum_code_post;
+    code += lazy_code_post;
 
     // Generate convenient global helper functions:
     if (parser.root_struct_def) {
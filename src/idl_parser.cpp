@@ -395,6 +395,19 @@ void Parser::ParseField(StructDef &struct_def) {
   if (field.required && (struct_def.fixed ||
                          IsScalar(field.value.type.base_type)))
     Error("only non-scalar fields in tables may be 'required'");
+  field.key = field.attributes.Lookup("key") != nullptr;
+  if (field.key) {
+    if (struct_def.fixed)
+      Error("only fields in tables may be a 'key'");
+    if (struct_def.has_key)
+      Error("only one field may be set as 'key'");
+    if (!IsScalar(field.value.type.base_type) &&
+        field.value.type.base_type != BASE_TYPE_STRING)
+      Error("'key' field must be a scalar or string");
+    struct_def.has_key = true;
+    // Comparing tables needs the key to be there.
+    if (!IsScalar(field.value.type.base_type)) field.required = true;
+  }
   auto nested = field.attributes.Lookup("nested_flatbuffer");
   if (nested) {
     if (nested->type.base_type != BASE_TYPE_STRING)
@@ -445,7 +458,9 @@ void Parser::ParseAnyValue(Value &val, FieldDef *field) {
     case BASE_TYPE_STRING: {
       auto s = attribute_;
       Expect(kTokenStringConstant);
-      val.constant = NumToString(builder_.CreateString(s).o);
+      val.constant = NumToString(share_strings_
+                                   ? builder_.CreateSharedString(s).o
+                                   : builder_.CreateString(s).o);
       break;
     }
     case BASE_TYPE_VECTOR: {
@@ -668,6 +683,7 @@ uoffset_t Parser::ParseTableSorted(const StructDef &struct_def) {
     if (IsNext('}')) break;
     Expect(',');
   }
+  fieldn += AddHashIndices(struct_def, fieldn);
   
   auto start = builder_.StartTable();
 
@@ -738,6 +754,7 @@ uoffset_t Parser::ParseTableUnsorted(const StructDef &struct_def) {
     if (IsNext('}')) break;
     Expect(',');
   }
+  fieldn += AddHashIndices(struct_def, fieldn);
   
   auto start = builder_.StartTable();
 
@@ -780,6 +797,97 @@ uoffset_t Parser::ParseTableUnsorted(const StructDef &struct_def) {
       static_cast<voffset_t>(struct_def.fields.vec.size()));
 }
 
+static const FieldDef &KeyField(const StructDef &struct_def) {
+  auto key = std::find_if(struct_def.fields.vec.begin(),
+                          struct_def.fields.vec.end(),
+                          [](const FieldDef *field) { return field->key; });
+  assert(key != struct_def.fields.vec.end());
+  return **key;
+}
+
+void Parser::SortByKey(const StructDef &struct_def,
+                       std::vector<std::pair<Value, FieldDef *>>::iterator first,
+                       std::vector<std::pair<Value, FieldDef *>>::iterator last) {
+  auto &field = KeyField(struct_def);
+  // The tables are in the buffer already, find them through their offsets.
+  auto buf = builder_.GetBufferPointer();
+  auto size = builder_.GetSize();
+  auto table = [&](const std::pair<Value, FieldDef *> &element) {
+    auto off = atot<uoffset_t>(element.first.constant.c_str());
+    return reinterpret_cast<const Table *>(buf + size - off);
+  };
+  std::stable_sort(first, last, [&](const std::pair<Value, FieldDef *> &a,
+                                    const std::pair<Value, FieldDef *> &b) {
+    auto ta = table(a);
+    auto tb = table(b);
+    switch (field.value.type.base_type) {
+      #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE) \
+        case BASE_TYPE_ ## ENUM: { \
+          auto def = atot<CTYPE>(field.value.constant.c_str()); \
+          return ta->GetField<CTYPE>(field.value.offset, def) < \
+                 tb->GetField<CTYPE>(field.value.offset, def); \
+        }
+        FLATBUFFERS_GEN_TYPES_SCALAR(FLATBUFFERS_TD)
+      #undef FLATBUFFERS_TD
+      default: {
+        auto sa = ta->GetPointer<const String *>(field.value.offset);
+        auto sb = tb->GetPointer<const String *>(field.value.offset);
+        return sa && sb ? *sa < *sb : sb != nullptr;
+      }
+    }
+  });
+}
+
+// Fields with the hash_index attribute that weren't given are filled in with
+// an index for the vector they belong to, if that was. Returns the number of
+// fields added to field_stack_.
+size_t Parser::AddHashIndices(const StructDef &struct_def, size_t fieldn) {
+  std::vector<std::pair<Value, FieldDef *>> indices;
+  for (auto it = struct_def.fields.vec.begin();
+       it != struct_def.fields.vec.end();
+       ++it) {
+    auto index_field = *it;
+    auto hash_index = index_field->attributes.Lookup("hash_index");
+    if (!hash_index) continue;
+    auto vec_field = struct_def.fields.Lookup(hash_index->constant);
+    const Value *vec_val = nullptr;
+    bool has_index = false;
+    for (auto fs = field_stack_.end() - fieldn; fs != field_stack_.end();
+         ++fs) {
+      if (fs->second == vec_field) vec_val = &fs->first;
+      if (fs->second == index_field) has_index = true;
+    }
+    if (!vec_val || has_index) continue;
+    auto &key = KeyField(*vec_field->value.type.struct_def);
+    auto vec = reinterpret_cast<const Vector<Offset<Table>> *>(
+      builder_.GetBufferPointer() + builder_.GetSize() -
+      atot<uoffset_t>(vec_val->constant.c_str()));
+    std::vector<uint32_t> hashes;
+    for (uoffset_t i = 0; i < vec->size(); i++) {
+      auto table = vec->Get(i);
+      switch (key.value.type.base_type) {
+        #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE) \
+          case BASE_TYPE_ ## ENUM: \
+            hashes.push_back(HashScalar(table->GetField<CTYPE>( \
+              key.value.offset, atot<CTYPE>(key.value.constant.c_str())))); \
+            break;
+          FLATBUFFERS_GEN_TYPES_SCALAR(FLATBUFFERS_TD)
+        #undef FLATBUFFERS_TD
+        default:
+          hashes.push_back(HashString(
+            table->GetPointer<const String *>(key.value.offset)));
+          break;
+      }
+    }
+    Value val = index_field->value;
+    val.constant = NumToString(
+      builder_.CreateHashIndex(hashes.data(), hashes.size()).o);
+    indices.push_back(std::make_pair(val, index_field));
+  }
+  field_stack_.insert(field_stack_.end(), indices.begin(), indices.end());
+  return indices.size();
+}
+
 uoffset_t Parser::ParseVector(const Type &type) {
   int count = 0;
   if (token_ != ']') for (;;) {
@@ -793,6 +901,11 @@ uoffset_t Parser::ParseVector(const Type &type) {
   }
   Next();
 
+  // Tables with a key are stored sorted by it, so they can be searched.
+  if (type.base_type == BASE_TYPE_STRUCT && type.struct_def->has_key) {
+    SortByKey(*type.struct_def, field_stack_.end() - count, field_stack_.end());
+  }
+
   builder_.StartVector(count * InlineSize(type) / InlineAlignment(type),
                        InlineAlignment(type));
   for (int i = 0; i < count; i++) {
@@ -1026,6 +1139,8 @@ void Parser::ParseDecl() {
   ParseMetaData(struct_def);
   struct_def.sortbysize =
     !fixed && struct_def.attributes.Lookup("original_order") == nullptr;
+  if (fixed && struct_def.attributes.Lookup("fixed_layout"))
+    Error("fixed_layout is only for tables");
   Expect('{');
   while (token_ != '}') ParseField(struct_def);
   auto force_align = struct_def.attributes.Lookup("force_align");
@@ -1334,6 +1449,26 @@ bool Parser::Parse(const char *source, const char **include_paths,
       if ((*it)->predecl)
         Error("type referenced but not defined: " + (*it)->name);
     }
+    for (auto it = structs_.vec.begin(); it != structs_.vec.end(); ++it) {
+      auto &struct_def = **it;
+      for (auto fit = struct_def.fields.vec.begin();
+           fit != struct_def.fields.vec.end();
+           ++fit) {
+        auto &field = **fit;
+        auto hash_index = field.attributes.Lookup("hash_index");
+        if (!hash_index) continue;
+        if (field.value.type.base_type != BASE_TYPE_VECTOR ||
+            field.value.type.element != BASE_TYPE_UINT)
+          Error("hash_index attribute may only apply to a vector of uint");
+        auto vec = struct_def.fields.Lookup(hash_index->constant);
+        if (hash_index->type.base_type != BASE_TYPE_STRING || !vec ||
+            vec->value.type.base_type != BASE_TYPE_VECTOR ||
+            vec->value.type.element != BASE_TYPE_STRUCT ||
+            !vec->value.type.struct_def->has_key)
+          Error("hash_index attribute must name a vector of tables with a key"
+                " in the same table: " + field.name);
+      }
+    }
     for (auto it = enums_.vec.begin(); it != enums_.vec.end(); ++it) {
       auto &enum_def = **it;
       if (enum_def.is_union) {
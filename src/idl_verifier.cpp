@@ -0,0 +1,263 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// independent from idl_parser, since this code is not needed for most clients
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/idl.h"
+
+namespace flatbuffers {
+
+static const uint32_t kNoTable = 0xFFFFFFFF;
+
+SchemaVerifier::SchemaVerifier(const Parser &parser,
+                               const StructDef *root_struct_def)
+    : root_(kNoTable) {
+  if (!root_struct_def) root_struct_def = parser.root_struct_def;
+  // Number the tables and unions, which the instructions refer to until
+  // we know where the instructions of each table start.
+  std::map<const StructDef *, uint32_t> tables;
+  std::map<const EnumDef *, uint32_t> unions;
+  for (auto it = parser.structs_.vec.begin();
+       it != parser.structs_.vec.end(); ++it) {
+    if (!(*it)->fixed) {
+      auto num = static_cast<uint32_t>(tables.size());
+      tables[*it] = num;
+    }
+  }
+  for (auto it = parser.enums_.vec.begin();
+       it != parser.enums_.vec.end(); ++it) {
+    if ((*it)->is_union) {
+      auto num = static_cast<uint32_t>(unions.size());
+      unions[*it] = num;
+    }
+  }
+  std::vector<uint32_t> table_starts(tables.size());
+  for (auto it = parser.structs_.vec.begin();
+       it != parser.structs_.vec.end(); ++it) {
+    if ((*it)->fixed) continue;
+    table_starts[tables[*it]] = static_cast<uint32_t>(program_.size());
+    CompileTable(parser, **it, tables, unions);
+  }
+  // Now point the instructions at the tables they refer to.
+  for (auto it = program_.begin(); it != program_.end(); ++it) {
+    if (it->op == kOpTable || it->op == kOpVectorOfTables ||
+        it->op == kOpNested) {
+      it->arg = table_starts[it->arg];
+    }
+  }
+  unions_.resize(unions.size());
+  for (auto it = unions.begin(); it != unions.end(); ++it) {
+    auto &types = unions_[it->second];
+    auto &vals = it->first->vals.vec;
+    for (auto val = vals.begin(); val != vals.end(); ++val) {
+      auto type = static_cast<size_t>((*val)->value);
+      if (type >= types.size()) types.resize(type + 1, kNoTable);
+      if ((*val)->struct_def)
+        types[type] = table_starts[tables[(*val)->struct_def]];
+    }
+  }
+  if (root_struct_def && !root_struct_def->fixed)
+    root_ = table_starts[tables[root_struct_def]];
+}
+
+void SchemaVerifier::CompileTable(
+                       const Parser &parser, const StructDef &struct_def,
+                       const std::map<const StructDef *, uint32_t> &tables,
+                       const std::map<const EnumDef *, uint32_t> &unions) {
+  std::vector<Instruction> hash_indices;
+  for (auto it = struct_def.fields.vec.begin();
+       it != struct_def.fields.vec.end(); ++it) {
+    auto &field = **it;
+    if (field.deprecated) continue;
+    auto &type = field.value.type;
+    Instruction ins;
+    ins.op = kOpField;
+    ins.required = field.required;
+    ins.field = field.value.offset;
+    ins.aux = 0;
+    ins.arg = static_cast<uint32_t>(SizeOf(type.base_type));
+    switch (type.base_type) {
+      case BASE_TYPE_STRING:
+        ins.op = kOpString;
+        break;
+      case BASE_TYPE_STRUCT:
+        if (type.struct_def->fixed) {
+          ins.arg = static_cast<uint32_t>(type.struct_def->bytesize);
+        } else {
+          ins.op = kOpTable;
+          ins.arg = tables.find(type.struct_def)->second;
+        }
+        break;
+      case BASE_TYPE_UNION:
+        ins.op = kOpUnion;
+        ins.aux = struct_def.fields.Lookup(field.name + "_type")->value.offset;
+        ins.arg = unions.find(type.enum_def)->second;
+        break;
+      case BASE_TYPE_VECTOR:
+        switch (type.element) {
+          case BASE_TYPE_STRING:
+            ins.op = kOpVectorOfStrings;
+            break;
+          case BASE_TYPE_STRUCT:
+            if (type.struct_def->fixed) {
+              ins.op = kOpVector;
+              ins.arg = static_cast<uint32_t>(type.struct_def->bytesize);
+            } else {
+              ins.op = kOpVectorOfTables;
+              ins.arg = tables.find(type.struct_def)->second;
+            }
+            break;
+          default:
+            ins.op = kOpVector;
+            ins.arg = static_cast<uint32_t>(SizeOf(type.element));
+            break;
+        }
+        break;
+      default:
+        break;
+    }
+    program_.push_back(ins);
+    // Extra checks on vectors, which run after the vector was checked.
+    auto nested = field.attributes.Lookup("nested_flatbuffer");
+    if (nested) {
+      ins.op = kOpNested;
+      ins.required = false;
+      ins.arg = tables.find(parser.structs_.Lookup(nested->constant))->second;
+      program_.push_back(ins);
+    }
+    // Hash indices also need the vector they index, so go last.
+    auto hash_index = field.attributes.Lookup("hash_index");
+    if (hash_index) {
+      ins.op = kOpHashIndex;
+      ins.required = false;
+      ins.aux = struct_def.fields.Lookup(hash_index->constant)->value.offset;
+      hash_indices.push_back(ins);
+    }
+  }
+  program_.insert(program_.end(), hash_indices.begin(), hash_indices.end());
+  Instruction end = { kOpEnd, 0, 0, 0, 0 };
+  program_.push_back(end);
+}
+
+bool SchemaVerifier::Verify(const uint8_t *buf, size_t buf_len,
+                            size_t max_depth, size_t max_tables,
+                            size_t max_bytes) const {
+  Verifier verifier(buf, buf_len, max_depth, max_tables, max_bytes);
+  return Verify(verifier);
+}
+
+bool SchemaVerifier::Verify(Verifier &verifier) const {
+  return root_ != kNoTable &&
+         verifier.VerifyBuffer([&](const uint8_t *root) {
+           return VerifyTable(verifier, reinterpret_cast<const Table *>(root),
+                              root_);
+         });
+}
+
+bool SchemaVerifier::VerifyTable(Verifier &verifier, const Table *table,
+                                 uint32_t pc) const {
+  if (!table->VerifyTableStart(verifier)) return false;
+  auto data = reinterpret_cast<const uint8_t *>(table);
+  for (auto ins = &program_[pc]; ins->op != kOpEnd; ins++) {
+    // Look up each field once, most are usually absent.
+    auto field_offset = table->GetOptionalFieldOffset(ins->field);
+    if (!field_offset) {
+      if (ins->required && !verifier.Check(false)) return false;
+      // An absent union must still have a known type, like in the generated
+      // code.
+      if (ins->op != kOpUnion) continue;
+    }
+    auto field = data + field_offset;
+    auto size = ins->op == kOpField ? ins->arg : sizeof(uoffset_t);
+    if (field_offset && ins->op < kOpNested &&
+        !verifier.Verify(field, size))
+      return false;
+    // Only read the offset once it's known to be there: a scalar field may
+    // be smaller, and end the buffer.
+    const uint8_t *pointer = nullptr;
+    if (field_offset && ins->op != kOpField)
+      pointer = field + ReadScalar<uoffset_t>(field);
+    switch (ins->op) {
+      case kOpField:
+        break;
+      case kOpString:
+        if (!verifier.Verify(reinterpret_cast<const String *>(pointer)))
+          return false;
+        break;
+      case kOpTable:
+        if (!VerifyTable(verifier, reinterpret_cast<const Table *>(pointer),
+                         ins->arg))
+          return false;
+        break;
+      case kOpVector: {
+        const uint8_t *end;
+        if (!verifier.VerifyVector(pointer, ins->arg, &end)) return false;
+        break;
+      }
+      case kOpVectorOfStrings: {
+        auto vec = reinterpret_cast<const Vector<Offset<String>> *>(pointer);
+        if (!verifier.Verify(vec) || !verifier.VerifyVectorOfStrings(vec))
+          return false;
+        break;
+      }
+      case kOpVectorOfTables: {
+        auto vec = reinterpret_cast<const Vector<Offset<Table>> *>(pointer);
+        auto table_pc = ins->arg;
+        if (!verifier.Verify(vec) ||
+            !verifier.VerifyVectorOfTables(vec, [&](Verifier &v,
+                                                    const Table *t) {
+              return VerifyTable(v, t, table_pc);
+            }))
+          return false;
+        break;
+      }
+      case kOpUnion: {
+        auto type = table->GetField<uint8_t>(ins->aux, 0);
+        if (!type) break;  // NONE.
+        auto &types = unions_[ins->arg];
+        if (!verifier.Check(type < types.size() && types[type] != kNoTable))
+          return false;
+        if (field_offset &&
+            !VerifyTable(verifier, reinterpret_cast<const Table *>(pointer),
+                         types[type]))
+          return false;
+        break;
+      }
+      case kOpNested: {
+        auto root_pc = ins->arg;
+        if (!verifier.VerifyNestedFlatBuffer(
+               reinterpret_cast<const Vector<uint8_t> *>(pointer),
+               [&](const uint8_t *root) {
+                 return VerifyTable(verifier,
+                                    reinterpret_cast<const Table *>(root),
+                                    root_pc);
+               }))
+          return false;
+        break;
+      }
+      case kOpHashIndex:
+        if (!verifier.VerifyHashIndex(
+               reinterpret_cast<const Vector<uint32_t> *>(pointer),
+               table->GetPointer<const Vector<uoffset_t> *>(ins->aux)))
+          return false;
+        break;
+    }
+  }
+  return verifier.EndTable();
+}
+
+}  // namespace flatbuffers
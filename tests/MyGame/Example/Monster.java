@@ -41,8 +41,11 @@ public class Monster extends Table {
   public ByteBuffer testnestedflatbufferAsByteBuffer() { return __vector_as_bytebuffer(30, 1); }
   public Stat testempty() { return testempty(new Stat()); }
   public Stat testempty(Stat obj) { int o = __offset(32); return o != 0 ? obj.__init(__indirect(o + bb_pos), bb) : null; }
+  public int testarrayoftablesIndex(int j) { int o = __offset(34); return o != 0 ? bb.getInt(__vector(o) + j * 4) : 0; }
+  public int testarrayoftablesIndexLength() { int o = __offset(34); return o != 0 ? __vector_len(o) : 0; }
+  public ByteBuffer testarrayoftablesIndexAsByteBuffer() { return __vector_as_bytebuffer(34, 4); }
 
-  public static void startMonster(FlatBufferBuilder builder) { builder.startObject(15); }
+  public static void startMonster(FlatBufferBuilder builder) { builder.startObject(16); }
   public static void addPos(FlatBufferBuilder builder, int posOffset) { builder.addStruct(0, posOffset, 0); }
   public static void addMana(FlatBufferBuilder builder, short mana) { builder.addShort(1, mana, 150); }
   public static void addHp(FlatBufferBuilder builder, short hp) { builder.addShort(2, hp, 100); }
@@ -66,6 +69,9 @@ public class Monster extends Table {
   public static int createTestnestedflatbufferVector(FlatBufferBuilder builder, byte[] data) { builder.startVector(1, data.length, 1); for (int i = data.length - 1; i >= 0; i--) builder.addByte(data[i]); return builder.endVector(); }
   public static void startTestnestedflatbufferVector(FlatBufferBuilder builder, int numElems) { builder.startVector(1, numElems, 1); }
   public static void addTestempty(FlatBufferBuilder builder, int testemptyOffset) { builder.addOffset(14, testemptyOffset, 0); }
+  public static void addTestarrayoftablesIndex(FlatBufferBuilder builder, int testarrayoftablesIndexOffset) { builder.addOffset(15, testarrayoftablesIndexOffset, 0); }
+  public static int createTestarrayoftablesIndexVector(FlatBufferBuilder builder, int[] data) { builder.startVector(4, data.length, 4); for (int i = data.length - 1; i >= 0; i--) builder.addInt(data[i]); return builder.endVector(); }
+  public static void startTestarrayoftablesIndexVector(FlatBufferBuilder builder, int numElems) { builder.startVector(4, numElems, 4); }
   public static int endMonster(FlatBufferBuilder builder) {
     int o = builder.endObject();
     builder.required(o, 10);  // name
@@ -0,0 +1,344 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/lazy_verifier.h"
+#include "flatbuffers/util.h"
+
+#include "monster_test_generated.h"
+
+#include <chrono>
+#include <thread>
+#include <stdio.h>
+
+using namespace MyGame::Example;
+
+// Micro benchmarks comparing ways of building or accessing the same data.
+// Not run as part of the tests, run "flatbenchmark" yourself (in an
+// optimized build).
+
+// Runs "body" "rounds" times, and reports the average time per "unit".
+template<typename F> double Time(const char *name, int rounds, int units,
+                                 F body) {
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < rounds; i++) body();
+  auto end = std::chrono::high_resolution_clock::now();
+  auto ns = std::chrono::duration<double, std::nano>(end - start).count() /
+            (static_cast<double>(rounds) * units);
+  printf("  %-30s %8.2f ns\n", name, ns);
+  return ns;
+}
+
+const int kRounds = 100;
+const int kTables = 10000;
+
+// Tables built with the generated CreateStat() vs StatFixedBuilder (from the
+// fixed_layout attribute).
+void FixedLayoutBenchmark() {
+  printf("Creating a Stat table:\n");
+  flatbuffers::FlatBufferBuilder builder(1 << 20);
+  auto generic = Time("CreateStat", kRounds, kTables, [&]() {
+    builder.Clear();
+    auto id = builder.CreateString("id");
+    for (int i = 0; i < kTables; i++) CreateStat(builder, id, i + 1);
+  });
+  auto fixed = Time("StatFixedBuilder", kRounds, kTables, [&]() {
+    builder.Clear();
+    auto id = builder.CreateString("id");
+    StatFixedBuilder stats(builder);
+    for (int i = 0; i < kTables; i++) stats.Create(id, i + 1);
+  });
+  printf("  speedup: %.2fx\n", generic / fixed);
+}
+
+// Looking up tables by key with binary search vs a hash index.
+void HashIndexBenchmark() {
+  const int kMonsters = 1000000;
+  const int kLookups = 100000;
+  printf("Looking up one of %d monsters by name:\n", kMonsters);
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  std::vector<std::string> names;
+  for (int i = 0; i < kMonsters; i++) {
+    names.push_back("Monster" + flatbuffers::NumToString(i));
+    monsters.push_back(CreateMonster(builder, nullptr, 150, 100,
+                                     builder.CreateString(names.back())));
+  }
+  auto vec = builder.CreateVectorOfSortedTables(&monsters);
+  auto index = builder.CreateHashIndex(monsters);
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Root"), 0,
+                                             Color_Blue, Any_NONE, 0, 0, 0,
+                                             vec, 0, 0, 0, index));
+  auto root = GetMonster(builder.GetBufferPointer());
+  int found = 0;
+  auto sorted = Time("LookupByKey", 1, kLookups, [&]() {
+    for (int i = 0; i < kLookups; i++) {
+      auto &name = names[(i * 7919) % kMonsters];
+      found += root->testarrayoftables()->LookupByKey(name.c_str()) != nullptr;
+    }
+  });
+  auto hashed = Time("hash index", 1, kLookups, [&]() {
+    for (int i = 0; i < kLookups; i++) {
+      auto &name = names[(i * 7919) % kMonsters];
+      found += root->testarrayoftables_find(name.c_str()) != nullptr;
+    }
+  });
+  printf("  speedup: %.2fx (found %d)\n", sorted / hashed, found);
+}
+
+// Reading most fields of a Monster through its accessors vs a MonsterView.
+void TableViewBenchmark() {
+  printf("Reading 8 fields of a Monster:\n");
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < kTables; i++) {
+    Vec3 pos(1, 2, 3, 0, Color_Red, Test(10, 20));
+    uint8_t inv[] = { 0, 1, 2 };
+    monsters.push_back(CreateMonster(builder, &pos, static_cast<int16_t>(i),
+                                     static_cast<int16_t>(i),
+                                     builder.CreateString("Monster"),
+                                     builder.CreateVector(inv, 3),
+                                     Color_Green));
+  }
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Root"), 0,
+                                             Color_Blue, Any_NONE, 0, 0, 0,
+                                             builder.CreateVector(monsters)));
+  auto tables = GetMonster(builder.GetBufferPointer())->testarrayoftables();
+  int64_t sum = 0;
+  auto plain = Time("Monster accessors", kRounds, kTables, [&]() {
+    for (auto it = tables->begin(); it != tables->end(); ++it) {
+      auto monster = *it;
+      sum += monster->pos()->x() + monster->mana() + monster->hp() +
+             monster->name()->size() + monster->inventory()->size() +
+             monster->color() + monster->test_type() +
+             (monster->enemy() != nullptr);
+    }
+  });
+  auto viewed = Time("MonsterView", kRounds, kTables, [&]() {
+    for (auto it = tables->begin(); it != tables->end(); ++it) {
+      MonsterView monster(*it);
+      sum += monster.pos()->x() + monster.mana() + monster.hp() +
+             monster.name()->size() + monster.inventory()->size() +
+             monster.color() + monster.test_type() +
+             (monster.enemy() != nullptr);
+    }
+  });
+  printf("  speedup: %.2fx (sum %lld)\n", plain / viewed,
+         static_cast<long long>(sum));
+}
+
+// Reading hp of every Monster in a vector through its accessor vs
+// ExtractColumn.
+void ExtractColumnBenchmark() {
+  const int kMonsters = 1000000;
+  printf("Reading hp of %d monsters:\n", kMonsters);
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < kMonsters; i++) {
+    monsters.push_back(CreateMonster(builder, nullptr, 150,
+                                     static_cast<int16_t>(i),
+                                     builder.CreateString("Monster")));
+  }
+  // Visit the tables in a scattered order, like a vector sorted by some
+  // other field would.
+  for (int i = kMonsters - 1; i > 0; i--)
+    std::swap(monsters[i], monsters[(i * 7919LL) % (i + 1)]);
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Root"), 0,
+                                             Color_Blue, Any_NONE, 0, 0, 0,
+                                             builder.CreateVector(monsters)));
+  auto tables = GetMonster(builder.GetBufferPointer())->testarrayoftables();
+  std::vector<int16_t> hp(kMonsters);
+  int64_t sum = 0;
+  auto plain = Time("Monster::hp()", 10, kMonsters, [&]() {
+    for (flatbuffers::uoffset_t i = 0; i < tables->size(); i++)
+      hp[i] = tables->Get(i)->hp();
+    sum += hp.back();
+  });
+  auto column = Time("ExtractColumn", 10, kMonsters, [&]() {
+    flatbuffers::ExtractColumn<MonsterFields::hp>(tables, hp.data());
+    sum += hp.back();
+  });
+  printf("  speedup: %.2fx (sum %lld)\n", plain / column,
+         static_cast<long long>(sum));
+}
+
+// Reading two fields of a Monster with 100000 child tables, after
+// verifying all of it vs through a LazyVerifier.
+void LazyVerifierBenchmark() {
+  const int kMonsters = 100000;
+  printf("Reading 2 fields of a monster with %d children:\n", kMonsters);
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < kMonsters; i++) {
+    monsters.push_back(CreateMonster(builder, nullptr, 150,
+                                     static_cast<int16_t>(i),
+                                     builder.CreateString("Monster")));
+  }
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Root"), 0,
+                                             Color_Blue, Any_NONE, 0, 0, 0,
+                                             builder.CreateVector(monsters)));
+  auto buf = builder.GetBufferPointer();
+  auto size = builder.GetSize();
+  int64_t sum = 0;
+  auto full = Time("VerifyMonsterBuffer", kRounds, 1, [&]() {
+    flatbuffers::Verifier verifier(buf, size);
+    if (VerifyMonsterBuffer(verifier)) {
+      auto monster = GetMonster(buf);
+      sum += monster->hp() + monster->name()->size();
+    }
+  });
+  auto lazy = Time("LazyVerifier", kRounds, 1, [&]() {
+    flatbuffers::LazyVerifier verifier(buf, size);
+    MonsterLazy monster(verifier.GetRoot<Monster>(), verifier);
+    if (monster && monster.name()) sum += monster.hp() + monster.name()->size();
+  });
+  printf("  speedup: %.2fx (sum %lld)\n", full / lazy,
+         static_cast<long long>(sum));
+}
+
+// Verifying a vector of Monsters that all share one vtable.
+void VerifierBenchmark() {
+  const int kMonsters = 1000000;
+  printf("Verifying %d monsters:\n", kMonsters);
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < kMonsters; i++) {
+    monsters.push_back(CreateMonster(builder, nullptr, 150,
+                                     static_cast<int16_t>(i),
+                                     builder.CreateString("Monster")));
+  }
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Root"), 0,
+                                             Color_Blue, Any_NONE, 0, 0, 0,
+                                             builder.CreateVector(monsters)));
+  int ok = 0;
+  auto generated = Time("VerifyMonsterBuffer", 10, kMonsters, [&]() {
+    flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                   builder.GetSize(), 64, 2 * kMonsters);
+    ok += VerifyMonsterBuffer(verifier);
+  });
+  auto num_threads = std::max(1U, std::thread::hardware_concurrency());
+  auto parallel = Time("VerifyMonsterBuffer, threads", 10, kMonsters, [&]() {
+    flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                   builder.GetSize(), 64, 2 * kMonsters);
+    verifier.UseThreads(num_threads, flatbuffers::RunOnThreads);
+    ok += VerifyMonsterBuffer(verifier);
+  });
+  printf("  speedup on %u threads: %.2fx\n", num_threads,
+         generated / parallel);
+  // The same, with the schema loaded at runtime (run from the root of the
+  // repository to find it).
+  std::string schemafile;
+  flatbuffers::Parser parser;
+  const char *include_directories[] = { "tests", nullptr };
+  if (flatbuffers::LoadFile("tests/monster_test.fbs", false, &schemafile) &&
+      parser.Parse(schemafile.c_str(), include_directories)) {
+    flatbuffers::SchemaVerifier schema_verifier(parser);
+    auto interpreted = Time("SchemaVerifier", 10, kMonsters, [&]() {
+      ok += schema_verifier.Verify(builder.GetBufferPointer(),
+                                   builder.GetSize(), 64, 2 * kMonsters);
+    });
+    printf("  relative to generated: %.2fx\n", interpreted / generated);
+  }
+  printf("  (verified %d)\n", ok);
+}
+
+// Verifying a few hundred vectors of tables that are just large enough to
+// be split, so threads are started for each of them.
+void NestedVectorsVerifierBenchmark() {
+  const int kOuter = 256, kInner = 4096;
+  const unsigned kThreads = 4;
+  printf("Verifying %d vectors of %d monsters:\n", kOuter, kInner);
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> outer;
+  for (int i = 0; i < kOuter; i++) {
+    std::vector<flatbuffers::Offset<Monster>> inner;
+    for (int j = 0; j < kInner; j++) {
+      inner.push_back(CreateMonster(builder, nullptr, 150,
+                                    static_cast<int16_t>(j),
+                                    builder.CreateString("Monster")));
+    }
+    outer.push_back(CreateMonster(builder, nullptr, 150, 1,
+                                  builder.CreateString("Outer"), 0,
+                                  Color_Blue, Any_NONE, 0, 0, 0,
+                                  builder.CreateVector(inner)));
+  }
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Root"), 0,
+                                             Color_Blue, Any_NONE, 0, 0, 0,
+                                             builder.CreateVector(outer)));
+  const size_t kTables = 1 + kOuter + kOuter * kInner;
+  int ok = 0;
+  auto serial = Time("VerifyMonsterBuffer", 10, kOuter, [&]() {
+    flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                   builder.GetSize(), 64, kTables);
+    ok += VerifyMonsterBuffer(verifier);
+  });
+  auto parallel = Time("VerifyMonsterBuffer, threads", 10, kOuter, [&]() {
+    flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                   builder.GetSize(), 64, kTables);
+    verifier.UseThreads(kThreads, flatbuffers::RunOnThreads);
+    ok += VerifyMonsterBuffer(verifier);
+  });
+  printf("  speedup on %u threads: %.2fx (verified %d)\n", kThreads,
+         serial / parallel, ok);
+}
+
+// Verifying a vector of many short strings, like tags.
+void StringVerifierBenchmark() {
+  const int kStrings = 1000000;
+  printf("Verifying %d strings:\n", kStrings);
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<flatbuffers::String>> strings;
+  for (int i = 0; i < kStrings; i++) {
+    strings.push_back(builder.CreateString("tag" +
+                                           flatbuffers::NumToString(i)));
+  }
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Root"), 0,
+                                             Color_Blue, Any_NONE, 0, 0,
+                                             builder.CreateVector(strings)));
+  int ok = 0;
+  Time("VerifyMonsterBuffer", 10, kStrings, [&]() {
+    flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                   builder.GetSize());
+    ok += VerifyMonsterBuffer(verifier);
+  });
+  Time("VerifyMonsterBuffer, UTF-8", 10, kStrings, [&]() {
+    flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                   builder.GetSize());
+    verifier.CheckUTF8(true);
+    ok += VerifyMonsterBuffer(verifier);
+  });
+  printf("  (verified %d)\n", ok);
+}
+
+int main(int /*argc*/, const char * /*argv*/[]) {
+  FixedLayoutBenchmark();
+  HashIndexBenchmark();
+  TableViewBenchmark();
+  ExtractColumnBenchmark();
+  LazyVerifierBenchmark();
+  VerifierBenchmark();
+  NestedVectorsVerifierBenchmark();
+  StringVerifierBenchmark();
+  return 0;
+}
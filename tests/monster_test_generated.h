@@ -4,6 +4,7 @@
 #define FLATBUFFERS_GENERATED_MONSTERTEST_MYGAME_EXAMPLE_H_
 
 #include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/lazy_verifier.h"
 
 namespace MyGame {
 namespace OtherNameSpace {
@@ -17,7 +18,9 @@ namespace Example {
 struct Test;
 struct Vec3;
 struct Stat;
+struct StatLazy;
 struct Monster;
+struct MonsterLazy;
 
 enum Color {
   Color_Red = 1,
@@ -88,7 +91,14 @@ STRUCT_END(Vec3, 32);
 
 struct Stat FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   const flatbuffers::String *id() const { return GetPointer<const flatbuffers::String *>(4); }
+  flatbuffers::string_view id_view() const { auto s = id(); return s ? s->str_view() : flatbuffers::string_view(); }
   int64_t val() const { return GetField<int64_t>(6, 0); }
+  enum : uint64_t {
+    Present_id = 1ULL << 0,
+    Present_val = 1ULL << 1,
+    RequiredFields = 0
+  };
+  uint64_t PresentFields() const { return PresentFieldBits(0, 2); }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<flatbuffers::uoffset_t>(verifier, 4 /* id */) &&
@@ -96,6 +106,29 @@ struct Stat FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            VerifyField<int64_t>(verifier, 6 /* val */) &&
            verifier.EndTable();
   }
+  bool VerifyShallow(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 4 /* id */) &&
+           VerifyField<int64_t>(verifier, 6 /* val */) &&
+           verifier.EndTable();
+  }
+};
+
+// Reads many fields of one Stat faster, use as a local variable.
+struct StatView FLATBUFFERS_FINAL_CLASS : private flatbuffers::TableView {
+  explicit StatView(const Stat *table) : flatbuffers::TableView(table) {}
+  const flatbuffers::String *id() const { return GetPointer<const flatbuffers::String *>(4); }
+  flatbuffers::string_view id_view() const { auto s = id(); return s ? s->str_view() : flatbuffers::string_view(); }
+  int64_t val() const { return GetField<int64_t>(6, 0); }
+};
+
+struct StatFields {
+  struct val {
+    typedef Stat table_type;
+    typedef int64_t value_type;
+    enum { offset = 6 };
+    static int64_t default_value() { return 0; }
+  };
 };
 
 struct StatBuilder {
@@ -103,6 +136,9 @@ struct StatBuilder {
   flatbuffers::uoffset_t start_;
   void add_id(flatbuffers::Offset<flatbuffers::String> id) { fbb_.AddOffset(4, id); }
   void add_val(int64_t val) { fbb_.AddElement<int64_t>(6, val, 0); }
+  // Upper bound on the size of one Stat (not counting what it refers to),
+  // e.g. for FlatBufferBuilder::Reserve().
+  enum { kInlineSizeEstimate = 44 };
   StatBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) { start_ = fbb_.StartTable(); }
   StatBuilder &operator=(const StatBuilder &);
   flatbuffers::Offset<Stat> Finish() {
@@ -120,11 +156,50 @@ inline flatbuffers::Offset<Stat> CreateStat(flatbuffers::FlatBufferBuilder &_fbb
   return builder_.Finish();
 }
 
+// Creates Stat tables with all fields present faster than CreateStat(),
+// since they all share one layout. The vtable is written again when the
+// builder was cleared.
+struct StatFixedBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t vtable_;
+  size_t clears_;
+  StatFixedBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb), vtable_(0), clears_(0) {}
+  StatFixedBuilder &operator=(const StatFixedBuilder &);
+  flatbuffers::Offset<Stat> Create(flatbuffers::Offset<flatbuffers::String> id, int64_t val) {
+    if (!vtable_ || clears_ != fbb_.GetClearCount()) {
+      static const flatbuffers::voffset_t field_offsets[] = { 4, 8 };
+      vtable_ = fbb_.CreateVtable(field_offsets, 2, 16);
+      clears_ = fbb_.GetClearCount();
+    }
+    auto table_ = fbb_.StartFixedTable(vtable_, 16, 8);
+    auto o_ = fbb_.GetSize();
+    assert(id.o);
+    flatbuffers::WriteScalar<flatbuffers::uoffset_t>(table_ + 4, o_ - 4 - id.o);
+    flatbuffers::WriteScalar<int64_t>(table_ + 8, val);
+    return flatbuffers::Offset<Stat>(o_);
+  }
+};
+
+// Reads a Stat from a buffer checked by a flatbuffers::LazyVerifier.
+struct StatLazy FLATBUFFERS_FINAL_CLASS {
+  StatLazy(const Stat *table, flatbuffers::LazyVerifier &verifier)
+    : table_(verifier.VerifyTable(table)), verifier_(&verifier) {}
+  // nullptr if absent or it didn't verify.
+  const Stat *get() const { return table_; }
+  explicit operator bool() const { return table_ != nullptr; }
+  const flatbuffers::String *id() const { return verifier_->VerifyString(table_->id()); }
+  int64_t val() const { return table_->val(); }
+ private:
+  const Stat *table_;
+  flatbuffers::LazyVerifier *verifier_;
+};
+
 struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   const Vec3 *pos() const { return GetStruct<const Vec3 *>(4); }
   int16_t mana() const { return GetField<int16_t>(6, 150); }
   int16_t hp() const { return GetField<int16_t>(8, 100); }
   const flatbuffers::String *name() const { return GetPointer<const flatbuffers::String *>(10); }
+  flatbuffers::string_view name_view() const { auto s = name(); return s ? s->str_view() : flatbuffers::string_view(); }
   const flatbuffers::Vector<uint8_t> *inventory() const { return GetPointer<const flatbuffers::Vector<uint8_t> *>(14); }
   Color color() const { return static_cast<Color>(GetField<int8_t>(16, 8)); }
   Any test_type() const { return static_cast<Any>(GetField<uint8_t>(18, 0)); }
@@ -136,8 +211,34 @@ struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   const flatbuffers::Vector<flatbuffers::Offset<Monster>> *testarrayoftables() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<Monster>> *>(26); }
   const Monster *enemy() const { return GetPointer<const Monster *>(28); }
   const flatbuffers::Vector<uint8_t> *testnestedflatbuffer() const { return GetPointer<const flatbuffers::Vector<uint8_t> *>(30); }
-  const Monster *testnestedflatbuffer_nested_root() { return flatbuffers::GetRoot<Monster>(testnestedflatbuffer()->Data()); }
+  const Monster *testnestedflatbuffer_nested_root() const { return flatbuffers::GetNestedRoot<Monster>(testnestedflatbuffer()); }
+  const Monster *testnestedflatbuffer_verified_nested_root() const { return flatbuffers::GetVerifiedNestedRoot<Monster>(testnestedflatbuffer()); }
   const Stat *testempty() const { return GetPointer<const Stat *>(32); }
+  const flatbuffers::Vector<uint32_t> *testarrayoftables_index() const { return GetPointer<const flatbuffers::Vector<uint32_t> *>(34); }
+  enum : uint64_t {
+    Present_pos = 1ULL << 0,
+    Present_mana = 1ULL << 1,
+    Present_hp = 1ULL << 2,
+    Present_name = 1ULL << 3,
+    Present_inventory = 1ULL << 5,
+    Present_color = 1ULL << 6,
+    Present_test_type = 1ULL << 7,
+    Present_test = 1ULL << 8,
+    Present_test4 = 1ULL << 9,
+    Present_testarrayofstring = 1ULL << 10,
+    Present_testarrayoftables = 1ULL << 11,
+    Present_enemy = 1ULL << 12,
+    Present_testnestedflatbuffer = 1ULL << 13,
+    Present_testempty = 1ULL << 14,
+    Present_testarrayoftables_index = 1ULL << 15,
+    RequiredFields = Present_name
+  };
+  uint64_t PresentFields() const { return PresentFieldBits(0, 16); }
+  bool KeyCompareLessThan(const Monster *o) const { return *name() < *o->name(); }
+  int KeyCompareWithValue(const char *_key) const { return name()->compare(_key); }
+  uint32_t KeyHash() const { return flatbuffers::HashString(name()); }
+  static uint32_t KeyHash(const char *_key) { return flatbuffers::HashString(_key); }
+  const Monster *testarrayoftables_find(const char *_key) const { return flatbuffers::LookupByHashIndex(testarrayoftables(), testarrayoftables_index(), _key); }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<Vec3>(verifier, 4 /* pos */) &&
@@ -163,12 +264,83 @@ struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            verifier.VerifyTable(enemy()) &&
            VerifyField<flatbuffers::uoffset_t>(verifier, 30 /* testnestedflatbuffer */) &&
            verifier.Verify(testnestedflatbuffer()) &&
+           verifier.VerifyNestedFlatBuffer<Monster>(testnestedflatbuffer()) &&
            VerifyField<flatbuffers::uoffset_t>(verifier, 32 /* testempty */) &&
            verifier.VerifyTable(testempty()) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 34 /* testarrayoftables_index */) &&
+           verifier.Verify(testarrayoftables_index()) &&
+           verifier.VerifyHashIndex(testarrayoftables_index(), testarrayoftables()) &&
+           verifier.EndTable();
+  }
+  bool VerifyShallow(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<Vec3>(verifier, 4 /* pos */) &&
+           VerifyField<int16_t>(verifier, 6 /* mana */) &&
+           VerifyField<int16_t>(verifier, 8 /* hp */) &&
+           VerifyFieldRequired<flatbuffers::uoffset_t>(verifier, 10 /* name */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 14 /* inventory */) &&
+           VerifyField<int8_t>(verifier, 16 /* color */) &&
+           VerifyField<uint8_t>(verifier, 18 /* test_type */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 20 /* test */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 22 /* test4 */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 24 /* testarrayofstring */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 26 /* testarrayoftables */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 28 /* enemy */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 30 /* testnestedflatbuffer */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 32 /* testempty */) &&
+           VerifyField<flatbuffers::uoffset_t>(verifier, 34 /* testarrayoftables_index */) &&
            verifier.EndTable();
   }
 };
 
+// Reads many fields of one Monster faster, use as a local variable.
+struct MonsterView FLATBUFFERS_FINAL_CLASS : private flatbuffers::TableView {
+  explicit MonsterView(const Monster *table) : flatbuffers::TableView(table) {}
+  const Vec3 *pos() const { return GetStruct<const Vec3 *>(4); }
+  int16_t mana() const { return GetField<int16_t>(6, 150); }
+  int16_t hp() const { return GetField<int16_t>(8, 100); }
+  const flatbuffers::String *name() const { return GetPointer<const flatbuffers::String *>(10); }
+  flatbuffers::string_view name_view() const { auto s = name(); return s ? s->str_view() : flatbuffers::string_view(); }
+  const flatbuffers::Vector<uint8_t> *inventory() const { return GetPointer<const flatbuffers::Vector<uint8_t> *>(14); }
+  Color color() const { return static_cast<Color>(GetField<int8_t>(16, 8)); }
+  Any test_type() const { return static_cast<Any>(GetField<uint8_t>(18, 0)); }
+  const void *test() const { return GetPointer<const void *>(20); }
+  const flatbuffers::Vector<const Test *> *test4() const { return GetPointer<const flatbuffers::Vector<const Test *> *>(22); }
+  const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *testarrayofstring() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *>(24); }
+  const flatbuffers::Vector<flatbuffers::Offset<Monster>> *testarrayoftables() const { return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<Monster>> *>(26); }
+  const Monster *enemy() const { return GetPointer<const Monster *>(28); }
+  const flatbuffers::Vector<uint8_t> *testnestedflatbuffer() const { return GetPointer<const flatbuffers::Vector<uint8_t> *>(30); }
+  const Stat *testempty() const { return GetPointer<const Stat *>(32); }
+  const flatbuffers::Vector<uint32_t> *testarrayoftables_index() const { return GetPointer<const flatbuffers::Vector<uint32_t> *>(34); }
+};
+
+struct MonsterFields {
+  struct mana {
+    typedef Monster table_type;
+    typedef int16_t value_type;
+    enum { offset = 6 };
+    static int16_t default_value() { return 150; }
+  };
+  struct hp {
+    typedef Monster table_type;
+    typedef int16_t value_type;
+    enum { offset = 8 };
+    static int16_t default_value() { return 100; }
+  };
+  struct color {
+    typedef Monster table_type;
+    typedef int8_t value_type;
+    enum { offset = 16 };
+    static int8_t default_value() { return 8; }
+  };
+  struct test_type {
+    typedef Monster table_type;
+    typedef uint8_t value_type;
+    enum { offset = 18 };
+    static uint8_t default_value() { return 0; }
+  };
+};
+
 struct MonsterBuilder {
   flatbuffers::FlatBufferBuilder &fbb_;
   flatbuffers::uoffset_t start_;
@@ -186,10 +358,14 @@ struct MonsterBuilder {
   void add_enemy(flatbuffers::Offset<Monster> enemy) { fbb_.AddOffset(28, enemy); }
   void add_testnestedflatbuffer(flatbuffers::Offset<flatbuffers::Vector<uint8_t>> testnestedflatbuffer) { fbb_.AddOffset(30, testnestedflatbuffer); }
   void add_testempty(flatbuffers::Offset<Stat> testempty) { fbb_.AddOffset(32, testempty); }
+  void add_testarrayoftables_index(flatbuffers::Offset<flatbuffers::Vector<uint32_t>> testarrayoftables_index) { fbb_.AddOffset(34, testarrayoftables_index); }
+  // Upper bound on the size of one Monster (not counting what it refers to),
+  // e.g. for FlatBufferBuilder::Reserve().
+  enum { kInlineSizeEstimate = 183 };
   MonsterBuilder(flatbuffers::FlatBufferBuilder &_fbb) : fbb_(_fbb) { start_ = fbb_.StartTable(); }
   MonsterBuilder &operator=(const MonsterBuilder &);
   flatbuffers::Offset<Monster> Finish() {
-    auto o = flatbuffers::Offset<Monster>(fbb_.EndTable(start_, 15));
+    auto o = flatbuffers::Offset<Monster>(fbb_.EndTable(start_, 16));
     fbb_.Required(o, 10);  // name
     return o;
   }
@@ -209,8 +385,10 @@ inline flatbuffers::Offset<Monster> CreateMonster(flatbuffers::FlatBufferBuilder
    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<Monster>>> testarrayoftables = 0,
    flatbuffers::Offset<Monster> enemy = 0,
    flatbuffers::Offset<flatbuffers::Vector<uint8_t>> testnestedflatbuffer = 0,
-   flatbuffers::Offset<Stat> testempty = 0) {
+   flatbuffers::Offset<Stat> testempty = 0,
+   flatbuffers::Offset<flatbuffers::Vector<uint32_t>> testarrayoftables_index = 0) {
   MonsterBuilder builder_(_fbb);
+  builder_.add_testarrayoftables_index(testarrayoftables_index);
   builder_.add_testempty(testempty);
   builder_.add_testnestedflatbuffer(testnestedflatbuffer);
   builder_.add_enemy(enemy);
@@ -228,6 +406,33 @@ inline flatbuffers::Offset<Monster> CreateMonster(flatbuffers::FlatBufferBuilder
   return builder_.Finish();
 }
 
+// Reads a Monster from a buffer checked by a flatbuffers::LazyVerifier.
+struct MonsterLazy FLATBUFFERS_FINAL_CLASS {
+  MonsterLazy(const Monster *table, flatbuffers::LazyVerifier &verifier)
+    : table_(verifier.VerifyTable(table)), verifier_(&verifier) {}
+  // nullptr if absent or it didn't verify.
+  const Monster *get() const { return table_; }
+  explicit operator bool() const { return table_ != nullptr; }
+  const Vec3 *pos() const { return table_->pos(); }
+  int16_t mana() const { return table_->mana(); }
+  int16_t hp() const { return table_->hp(); }
+  const flatbuffers::String *name() const { return verifier_->VerifyString(table_->name()); }
+  const flatbuffers::Vector<uint8_t> *inventory() const { return verifier_->VerifyVector(table_->inventory()); }
+  Color color() const { return table_->color(); }
+  Any test_type() const { return table_->test_type(); }
+  const void *test() const { return verifier_->VerifyUnion(table_->test(), table_->test_type(), VerifyAny); }
+  const flatbuffers::Vector<const Test *> *test4() const { return verifier_->VerifyVector(table_->test4()); }
+  const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>> *testarrayofstring() const { return verifier_->VerifyVectorOfStrings(table_->testarrayofstring()); }
+  flatbuffers::LazyVector<Monster, MonsterLazy> testarrayoftables() const;
+  MonsterLazy enemy() const;
+  const flatbuffers::Vector<uint8_t> *testnestedflatbuffer() const { return verifier_->VerifyVector(table_->testnestedflatbuffer()); }
+  StatLazy testempty() const;
+  const flatbuffers::Vector<uint32_t> *testarrayoftables_index() const { return verifier_->VerifyVector(table_->testarrayoftables_index()); }
+ private:
+  const Monster *table_;
+  flatbuffers::LazyVerifier *verifier_;
+};
+
 inline bool VerifyAny(flatbuffers::Verifier &verifier, const void *union_obj, Any type) {
   switch (type) {
     case Any_NONE: return true;
@@ -236,6 +441,12 @@ inline bool VerifyAny(flatbuffers::Verifier &verifier, const void *union_obj, An
   }
 }
 
+inline flatbuffers::LazyVector<Monster, MonsterLazy> MonsterLazy::testarrayoftables() const { return flatbuffers::LazyVector<Monster, MonsterLazy>(table_->testarrayoftables(), *verifier_); }
+
+inline MonsterLazy MonsterLazy::enemy() const { return MonsterLazy(table_->enemy(), *verifier_); }
+
+inline StatLazy MonsterLazy::testempty() const { return StatLazy(table_->testempty(), *verifier_); }
+
 inline const Monster *GetMonster(const void *buf) { return flatbuffers::GetRoot<Monster>(buf); }
 
 inline bool VerifyMonsterBuffer(flatbuffers::Verifier &verifier) { return verifier.VerifyBuffer<Monster>(); }
@@ -16,11 +16,13 @@
 
 #include "flatbuffers/flatbuffers.h"
 #include "flatbuffers/idl.h"
+#include "flatbuffers/lazy_verifier.h"
 #include "flatbuffers/util.h"
 
 #include "monster_test_generated.h"
 #include "mutate_test_generated.h"
 
+#include <bitset>
 #include <random>
 
 using namespace MyGame::Example;
@@ -371,6 +373,1270 @@ void FuzzTest1() {
   }
 }
 
+// Returns the address of the vtable of the table at "table_off" (an offset
+// from the end of the buffer, as returned by EndTable()).
+const uint8_t *VtableOf(flatbuffers::FlatBufferBuilder &builder,
+                        flatbuffers::uoffset_t table_off) {
+  auto table = builder.GetBufferPointer() + builder.GetSize() - table_off;
+  return table - flatbuffers::ReadScalar<flatbuffers::soffset_t>(table);
+}
+
+// Tables with the same layout must share a vtable, also once enough distinct
+// layouts have been written to make the vtable index grow.
+void VtableDedupTest() {
+  const int num_layouts = 100;
+  const int copies = 3;
+  flatbuffers::uoffset_t objects[num_layouts * copies];
+
+  flatbuffers::FlatBufferBuilder builder;
+  for (int i = 0; i < num_layouts * copies; i++) {
+    auto layout = i % num_layouts;
+    auto start = builder.StartTable();
+    for (flatbuffers::voffset_t f = 0; f < 8; f++) {
+      if (layout & (1 << f) || f == 7)
+        builder.AddElement<int32_t>(flatbuffers::FieldIndexToOffset(f), i + 1, 0);
+    }
+    objects[i] = builder.EndTable(start, 8);
+  }
+  for (int i = num_layouts; i < num_layouts * copies; i++) {
+    TEST_EQ(VtableOf(builder, objects[i]) ==
+            VtableOf(builder, objects[i % num_layouts]), true);
+  }
+  for (int i = 1; i < num_layouts; i++) {
+    TEST_EQ(VtableOf(builder, objects[i]) == VtableOf(builder, objects[0]),
+            false);
+  }
+  auto dedup_size = builder.GetSize();
+
+  // Without sharing every table gets its own vtable.
+  flatbuffers::FlatBufferBuilder builder2;
+  builder2.DedupVtables(0);
+  for (int i = 0; i < 2; i++) {
+    auto start = builder2.StartTable();
+    builder2.AddElement<int32_t>(flatbuffers::FieldIndexToOffset(0), 1, 0);
+    objects[i] = builder2.EndTable(start, 1);
+  }
+  TEST_EQ(VtableOf(builder2, objects[0]) == VtableOf(builder2, objects[1]),
+          false);
+
+  // Clear() must forget the vtables of the previous buffer.
+  builder.Clear();
+  for (int i = 0; i < num_layouts * copies; i++) {
+    auto layout = i % num_layouts;
+    auto start = builder.StartTable();
+    for (flatbuffers::voffset_t f = 0; f < 8; f++) {
+      if (layout & (1 << f) || f == 7)
+        builder.AddElement<int32_t>(flatbuffers::FieldIndexToOffset(f), i + 1, 0);
+    }
+    objects[i] = builder.EndTable(start, 8);
+  }
+  TEST_EQ(builder.GetSize(), dedup_size);
+}
+
+// Identical strings created with CreateSharedString are stored once.
+void SharedStringTest() {
+  flatbuffers::FlatBufferBuilder builder(64);  // Small, to force growth.
+  std::vector<flatbuffers::Offset<flatbuffers::String>> strings;
+  for (int i = 0; i < 1000; i++) {
+    strings.push_back(builder.CreateSharedString(
+      "name" + flatbuffers::NumToString(i % 50)));
+  }
+  auto s1 = builder.CreateSharedString("a\0b", 3);
+  auto s2 = builder.CreateSharedString("a\0c", 3);
+  auto s3 = builder.CreateSharedString("a", 1);
+  TEST_EQ(s1.o != s2.o && s1.o != s3.o && s2.o != s3.o, true);
+  TEST_EQ(builder.CreateSharedString("a\0b", 3).o, s1.o);
+  // Non-shared strings are not pooled.
+  TEST_EQ(builder.CreateString("name0").o != strings[0].o, true);
+  for (int i = 50; i < 1000; i++) {
+    TEST_EQ(strings[i].o, strings[i % 50].o);
+  }
+  auto vec = builder.CreateVector(strings);
+  builder.Finish(vec);
+  auto root = flatbuffers::GetRoot<flatbuffers::Vector<
+                flatbuffers::Offset<flatbuffers::String>>>(
+                  builder.GetBufferPointer());
+  for (flatbuffers::uoffset_t i = 0; i < root->size(); i++) {
+    TEST_EQ(root->Get(i)->str(), "name" + flatbuffers::NumToString(i % 50));
+  }
+
+  // Same for strings in JSON, when enabled in the parser.
+  flatbuffers::Parser parser;
+  parser.ShareStrings(true);
+  TEST_EQ(parser.Parse("table T { A:string; B:[string]; } root_type T;"
+                       "{ A: \"x\", B: [ \"x\", \"y\", \"x\" ] }"), true);
+  auto t = flatbuffers::GetRoot<flatbuffers::Table>(
+             parser.builder_.GetBufferPointer());
+  auto a = t->GetPointer<const flatbuffers::String *>(
+             flatbuffers::FieldIndexToOffset(0));
+  auto b = t->GetPointer<const flatbuffers::Vector<
+             flatbuffers::Offset<flatbuffers::String>> *>(
+               flatbuffers::FieldIndexToOffset(1));
+  TEST_EQ(a == b->Get(0) && a == b->Get(2), true);
+  TEST_EQ(b->Get(1)->str(), "y");
+}
+
+// Allocator that keeps track of how many blocks are still allocated.
+class CountingAllocator : public flatbuffers::simple_allocator {
+ public:
+  CountingAllocator() : live(0) {}
+  uint8_t *allocate(size_t size) const {
+    live++;
+    return flatbuffers::simple_allocator::allocate(size);
+  }
+  void deallocate(uint8_t *p) const {
+    live--;
+    flatbuffers::simple_allocator::deallocate(p);
+  }
+  mutable int live;
+};
+
+// Finished buffers can be taken from the builder without copying, and
+// outlive it.
+void ReleaseBufferTest() {
+  CountingAllocator allocator;
+  flatbuffers::DetachedBuffer released;
+  {
+    flatbuffers::FlatBufferBuilder builder(16, &allocator);
+    for (int i = 0; i < 2; i++) {  // Builder is reusable after Release().
+      auto name = builder.CreateString("MyMonster");
+      MonsterBuilder mb(builder);
+      mb.add_name(name);
+      mb.add_hp(static_cast<int16_t>(i));
+      FinishMonsterBuffer(builder, mb.Finish());
+      auto data = builder.GetBufferPointer();
+      auto size = builder.GetSize();
+      released = builder.Release();
+      TEST_EQ(released.data() == data, true);
+      TEST_EQ(released.size(), size);
+      TEST_EQ(builder.GetSize(), 0U);
+    }
+    TEST_EQ(allocator.live, 1);  // The first buffer was freed on assignment.
+  }
+  TEST_EQ(allocator.live, 1);  // The builder is gone, the buffer isn't.
+  flatbuffers::Verifier verifier(released.data(), released.size());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  TEST_EQ(GetMonster(released.data())->hp(), 1);
+
+  auto moved = std::move(released);
+  TEST_EQ(released.data() == nullptr, true);
+  TEST_EQ(GetMonster(moved.data())->hp(), 1);
+  moved = flatbuffers::DetachedBuffer();
+  TEST_EQ(allocator.live, 0);
+
+  // The default allocator must outlive the builder too.
+  flatbuffers::DetachedBuffer buf;
+  {
+    flatbuffers::FlatBufferBuilder builder;
+    auto name = builder.CreateString("MyMonster");
+    MonsterBuilder mb(builder);
+    mb.add_name(name);
+    FinishMonsterBuffer(builder, mb.Finish());
+    buf = builder.Release();
+  }
+  TEST_EQ(GetMonster(buf.data())->name()->str(), "MyMonster");
+}
+
+size_t GrowByDoubling(size_t reserved) { return reserved; }
+
+// Builds the same large buffer every time.
+void BuildLargeBuffer(flatbuffers::FlatBufferBuilder &builder) {
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < 20000; i++) {
+    auto name = builder.CreateString("Monster" + flatbuffers::NumToString(i));
+    monsters.push_back(CreateMonster(builder, nullptr, 150,
+                                     static_cast<int16_t>(i), name));
+  }
+  auto vec = builder.CreateVector(monsters);
+  auto name = builder.CreateString("Root");
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80, name,
+                                             0, Color_Blue, Any_NONE, 0, 0,
+                                             0, vec));
+}
+
+// Builds the large buffer with a given allocator and growth policy.
+std::string BuildLargeBuffer(const flatbuffers::simple_allocator *allocator,
+                             flatbuffers::growth_policy_t policy) {
+  flatbuffers::FlatBufferBuilder builder(64, allocator);
+  if (policy) builder.SetGrowthPolicy(policy);
+  BuildLargeBuffer(builder);
+  return std::string(reinterpret_cast<const char *>(builder.GetBufferPointer()),
+                     builder.GetSize());
+}
+
+// Growing the buffer must keep its contents intact, however it happens.
+void BufferGrowthTest() {
+  auto expected = BuildLargeBuffer(nullptr, nullptr);
+  flatbuffers::Verifier verifier(
+    reinterpret_cast<const uint8_t *>(expected.c_str()), expected.length());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  TEST_EQ(BuildLargeBuffer(nullptr, GrowByDoubling) == expected, true);
+  #ifdef __linux__
+    flatbuffers::mmap_allocator mmap_allocator;
+    TEST_EQ(BuildLargeBuffer(&mmap_allocator, nullptr) == expected, true);
+    TEST_EQ(BuildLargeBuffer(&mmap_allocator, GrowByDoubling) == expected,
+            true);
+  #endif
+}
+
+// A buffer built in small chunks must verify once its segments are gathered.
+void ChunkedBuilderTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  builder.UseChunks(256);
+  for (int pass = 0; pass < 2; pass++) {
+    builder.Clear();
+    std::vector<flatbuffers::Offset<Monster>> monsters;
+    for (int i = 0; i < 1000; i++) {
+      auto name = builder.CreateString("Monster" +
+                                       flatbuffers::NumToString(i));
+      monsters.push_back(CreateMonster(builder, nullptr, 150,
+                                       static_cast<int16_t>(i), name));
+    }
+    auto vec = builder.CreateVector(monsters);
+    auto name = builder.CreateString(std::string(1000, 'x'));  // > 1 chunk.
+    FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80, name,
+                                               0, Color_Blue, Any_NONE, 0, 0,
+                                               0, vec));
+    auto segments = builder.GetBufferSegments();
+    TEST_EQ(segments.size() > 1, true);
+    std::string flatbuf;
+    for (auto it = segments.begin(); it != segments.end(); ++it) {
+      flatbuf.append(reinterpret_cast<const char *>(it->data), it->size);
+    }
+    TEST_EQ(flatbuf.length(), builder.GetSize());
+    flatbuffers::Verifier verifier(
+      reinterpret_cast<const uint8_t *>(flatbuf.c_str()), flatbuf.length());
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    auto monster = GetMonster(flatbuf.c_str());
+    TEST_EQ(monster->name()->size(), 1000U);
+    TEST_EQ(monster->testarrayoftables()->size(), 1000U);
+    TEST_EQ(monster->testarrayoftables()->Get(999)->name()->str(),
+            "Monster999");
+    TEST_EQ(monster->testarrayoftables()->Get(500)->hp(), 500);
+    // Releasing it joins the chunks.
+    auto released = builder.Release();
+    TEST_EQ(released.size(), flatbuf.length());
+    TEST_EQ(memcmp(released.data(), flatbuf.c_str(), flatbuf.length()), 0);
+  }
+}
+
+// Builds a buffer whose root is just a vector.
+template<typename T, typename F> const flatbuffers::Vector<T> *BuildVector(
+                            flatbuffers::FlatBufferBuilder &builder, F create) {
+  builder.Clear();
+  builder.Finish(create(builder));
+  return flatbuffers::GetRoot<flatbuffers::Vector<T>>(
+    builder.GetBufferPointer());
+}
+
+// Scalar vectors are copied in bulk, which must match element-wise storage.
+void BulkVectorTest() {
+  flatbuffers::FlatBufferBuilder builder;
+
+  std::vector<double> doubles;
+  for (int i = 0; i < 1001; i++) doubles.push_back(i * 0.5);
+  auto dvec = BuildVector<double>(builder,
+    [&](flatbuffers::FlatBufferBuilder &b) { return b.CreateVector(doubles); });
+  TEST_EQ(dvec->size(), 1001U);
+  TEST_EQ(dvec->Get(1000), 500.0);
+  TEST_EQ(reinterpret_cast<size_t>(dvec->Data()) % sizeof(double), 0U);
+
+  int16_t shorts[] = { -1, 2, -3 };
+  auto svec = BuildVector<int16_t>(builder,
+    [&](flatbuffers::FlatBufferBuilder &b) {
+      return b.CreateVector(shorts, 3);
+    });
+  TEST_EQ(svec->size(), 3U);
+  TEST_EQ(svec->Get(2), -3);
+
+  std::vector<bool> bools = { true, false, true, true };
+  auto bvec = BuildVector<uint8_t>(builder,
+    [&](flatbuffers::FlatBufferBuilder &b) { return b.CreateVector(bools); });
+  TEST_EQ(bvec->size(), 4U);
+  TEST_EQ(bvec->Get(1), 0);
+  TEST_EQ(bvec->Get(3), 1);
+
+  std::vector<Color> colors = { Color_Red, Color_Blue, Color_Green };
+  auto cvec = BuildVector<int8_t>(builder,
+    [&](flatbuffers::FlatBufferBuilder &b) {
+      return b.CreateVectorOfEnums<int8_t>(colors);
+    });
+  TEST_EQ(cvec->size(), 3U);
+  TEST_EQ(cvec->Get(1), Color_Blue);
+  TEST_EQ(cvec->Get(2), Color_Green);
+}
+
+// Builds a Monster with children, returns its size excluding the children.
+size_t BuildFullMonster(flatbuffers::FlatBufferBuilder &builder) {
+  auto name = builder.CreateString("MyMonster");
+  unsigned char inv[] = { 0, 1, 2 };
+  auto inventory = builder.CreateVector(inv, 3);
+  auto enemy = CreateMonster(builder, nullptr, 150, 80, name);
+  std::vector<flatbuffers::Offset<Monster>> monsters(1, enemy);
+  auto tables = builder.CreateVector(monsters);
+  std::vector<flatbuffers::Offset<flatbuffers::String>> names(1, name);
+  auto strings = builder.CreateVector(names);
+  Test tests[] = { Test(10, 20) };
+  auto test4 = builder.CreateVectorOfStructs(tests, 1);
+  auto stat = CreateStat(builder, name, 10);
+  auto before = builder.GetSize();
+  Vec3 vec(1, 2, 3, 0, Color_Red, Test(10, 20));
+  auto mloc = CreateMonster(builder, &vec, 1, 2, name, inventory, Color_Red,
+                            Any_Monster, enemy.Union(), test4, strings,
+                            tables, enemy, inventory, stat);
+  builder.Finish(mloc);
+  return builder.GetSize() - before;
+}
+
+void SizeHintTest() {
+  {
+    flatbuffers::FlatBufferBuilder builder;
+    builder.DedupVtables(0);
+    auto monster_size = BuildFullMonster(builder);
+    TEST_EQ(monster_size <= MonsterBuilder::kInlineSizeEstimate, true);
+  }
+  // Reserving enough up front means the buffer never has to grow.
+  {
+    flatbuffers::FlatBufferBuilder builder(64);
+    BuildLargeBuffer(builder);
+    TEST_EQ(builder.GetReallocationCount() > 0, true);
+  }
+  {
+    flatbuffers::FlatBufferBuilder builder(64);
+    builder.Reserve(20000 * (MonsterBuilder::kInlineSizeEstimate + 20));
+    BuildLargeBuffer(builder);
+    TEST_EQ(builder.GetReallocationCount(), 0U);
+  }
+  // A builder can learn how big its buffers get.
+  {
+    flatbuffers::FlatBufferBuilder builder(64);
+    builder.LearnInitialSize(4);
+    BuildLargeBuffer(builder);
+    auto first = builder.Release();
+    auto reallocations = builder.GetReallocationCount();
+    BuildLargeBuffer(builder);
+    TEST_EQ(builder.GetReallocationCount(), reallocations);
+    TEST_EQ(builder.GetSize(), first.size());
+  }
+}
+
+// External vectors stay where they are until the buffer is written out.
+void ExternalVectorTest() {
+  std::vector<uint8_t> blob(100001);
+  for (size_t i = 0; i < blob.size(); i++) blob[i] = static_cast<uint8_t>(i);
+  flatbuffers::FlatBufferBuilder nested_builder;
+  FinishMonsterBuffer(nested_builder, CreateMonster(nested_builder, nullptr,
+                                                    150, 80,
+                                                    nested_builder.CreateString(
+                                                      "Nested")));
+  for (int chunked = 0; chunked < 2; chunked++) {
+    flatbuffers::FlatBufferBuilder builder;
+    if (chunked) builder.UseChunks(1024);
+    auto inventory = builder.CreateExternalVector(blob.data(), blob.size());
+    auto name = builder.CreateString("MyMonster");
+    auto nested = builder.CreateExternalVector(
+                    nested_builder.GetBufferPointer(), nested_builder.GetSize());
+    auto mloc = CreateMonster(builder, nullptr, 150, 80, name, inventory,
+                              Color_Blue, Any_NONE, 0, 0, 0, 0, 0, nested);
+    FinishMonsterBuffer(builder, mloc);
+
+    auto segments = builder.GetBufferSegments();
+    std::string flatbuf;
+    bool referenced = false;
+    for (auto it = segments.begin(); it != segments.end(); ++it) {
+      flatbuf.append(reinterpret_cast<const char *>(it->data), it->size);
+      if (it->data == blob.data()) referenced = true;
+    }
+    TEST_EQ(referenced, true);
+    TEST_EQ(flatbuf.length(), builder.GetSize());
+    flatbuffers::Verifier verifier(
+      reinterpret_cast<const uint8_t *>(flatbuf.c_str()), flatbuf.length());
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    auto monster = GetMonster(flatbuf.c_str());
+    TEST_EQ(monster->name()->str(), "MyMonster");
+    TEST_EQ(monster->inventory()->size(), blob.size());
+    TEST_EQ(memcmp(monster->inventory()->Data(), blob.data(), blob.size()),
+            0);
+    TEST_EQ(monster->testnestedflatbuffer_nested_root()->name()->str(),
+            "Nested");
+
+    // The contiguous buffer is the same.
+    if (!chunked) {
+      TEST_EQ(memcmp(builder.GetBufferPointer(), flatbuf.c_str(),
+                     flatbuf.length()), 0);
+      auto released = builder.Release();
+      TEST_EQ(released.size(), flatbuf.length());
+      TEST_EQ(memcmp(released.data(), flatbuf.c_str(), flatbuf.length()), 0);
+    }
+  }
+}
+
+// Adds fields in an order that needs a lot of padding.
+std::string BuildUnorderedMonster(bool sort_fields) {
+  flatbuffers::FlatBufferBuilder builder;
+  builder.SortFields(sort_fields);
+  auto name = builder.CreateString("MyMonster");
+  unsigned char inv[] = { 0, 1, 2 };
+  auto inventory = builder.CreateVector(inv, 3);
+  Vec3 vec(1, 2, 3, 0, Color_Red, Test(10, 20));
+  MonsterBuilder mb(builder);
+  mb.add_color(Color_Red);
+  mb.add_name(name);
+  mb.add_hp(80);
+  mb.add_pos(&vec);
+  mb.add_test_type(Any_NONE);
+  mb.add_inventory(inventory);
+  mb.add_mana(200);
+  FinishMonsterBuffer(builder, mb.Finish());
+  return std::string(reinterpret_cast<const char *>(builder.GetBufferPointer()),
+                     builder.GetSize());
+}
+
+// Sorting fields saves space, and gives the same data.
+void SortFieldsTest() {
+  auto unsorted = BuildUnorderedMonster(false);
+  auto sorted = BuildUnorderedMonster(true);
+  TEST_EQ(sorted.length() < unsorted.length(), true);
+  for (int i = 0; i < 2; i++) {
+    auto &flatbuf = i ? sorted : unsorted;
+    flatbuffers::Verifier verifier(
+      reinterpret_cast<const uint8_t *>(flatbuf.c_str()), flatbuf.length());
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    auto monster = GetMonster(flatbuf.c_str());
+    TEST_EQ(monster->hp(), 80);
+    TEST_EQ(monster->mana(), 200);
+    TEST_EQ(monster->color(), Color_Red);
+    TEST_EQ(monster->name()->str(), "MyMonster");
+    TEST_EQ(monster->inventory()->Get(2), 2);
+    TEST_EQ(monster->pos()->test3().b(), 20);
+  }
+}
+
+// Tables from a fixed layout builder read the same as generic ones.
+void FixedLayoutTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  auto id = builder.CreateString("hp");
+  StatFixedBuilder stats(builder);
+  auto first = stats.Create(id, 10);
+  auto size = builder.GetSize();
+  auto stat = stats.Create(id, -20);
+  // Only the first table comes with a vtable.
+  TEST_EQ(builder.GetSize() - size, 16U);
+  auto name = builder.CreateString("MyMonster");
+  auto enemy = CreateMonster(builder, nullptr, 150, 80, name, 0, Color_Blue,
+                             Any_NONE, 0, 0, 0, 0, 0, 0, first);
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80, name,
+                                             0, Color_Blue, Any_NONE, 0, 0,
+                                             0, 0, enemy, 0, stat));
+  flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                 builder.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  auto monster = GetMonster(builder.GetBufferPointer());
+  TEST_EQ(monster->testempty()->id()->str(), "hp");
+  TEST_EQ(monster->testempty()->val(), -20);
+  TEST_EQ(monster->enemy()->testempty()->val(), 10);
+
+  // Reused after Clear(), it writes the vtable into the new buffer.
+  builder.Clear();
+  auto cleared_id = builder.CreateString("mp");
+  auto cleared_stat = stats.Create(cleared_id, 30);
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Cleared"),
+                                             0, Color_Blue, Any_NONE, 0, 0,
+                                             0, 0, 0, 0, cleared_stat));
+  flatbuffers::Verifier cleared_verifier(builder.GetBufferPointer(),
+                                         builder.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(cleared_verifier), true);
+  auto cleared = GetMonster(builder.GetBufferPointer());
+  TEST_EQ(cleared->testempty()->id()->str(), "mp");
+  TEST_EQ(cleared->testempty()->val(), 30);
+}
+
+// Vectors of tables with a key can be searched by it.
+void KeyLookupTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  const char *names[] = { "Wilma", "Barney", "Fred", "Dino", "Betty" };
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < 5; i++) {
+    monsters.push_back(CreateMonster(builder, nullptr, 150,
+                                     static_cast<int16_t>(i),
+                                     builder.CreateString(names[i])));
+  }
+  auto vec = builder.CreateVectorOfSortedTables(&monsters);
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Root"), 0,
+                                             Color_Blue, Any_NONE, 0, 0, 0,
+                                             vec));
+  auto tables = GetMonster(builder.GetBufferPointer())->testarrayoftables();
+  TEST_EQ(tables->Get(0)->name()->str(), "Barney");
+  TEST_EQ(tables->Get(4)->name()->str(), "Wilma");
+  for (int i = 0; i < 5; i++) {
+    auto monster = tables->LookupByKey(names[i]);
+    TEST_NOTNULL(monster);
+    TEST_EQ(monster->hp(), i);
+  }
+  TEST_EQ(tables->LookupByKey("Bamm-Bamm") == nullptr, true);
+  TEST_EQ(tables->LookupByKey("Zed") == nullptr, true);
+
+  // The parser sorts them too.
+  flatbuffers::Parser parser;
+  std::string schemafile;
+  TEST_EQ(flatbuffers::LoadFile("tests/monster_test.fbs", false, &schemafile),
+          true);
+  const char *include_directories[] = { "tests", nullptr };
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+  TEST_EQ(parser.Parse("{ name: \"Root\", testarrayoftables: ["
+                       "{ name: \"b\" }, { name: \"c\" }, { name: \"a\" }"
+                       "] }"), true);
+  tables = GetMonster(parser.builder_.GetBufferPointer())->testarrayoftables();
+  TEST_EQ(tables->Get(0)->name()->str(), "a");
+  TEST_EQ(tables->Get(2)->name()->str(), "c");
+  TEST_NOTNULL(tables->LookupByKey("b"));
+}
+
+// A hash index finds the same tables as binary search.
+void HashIndexTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < 1000; i++) {
+    auto name = builder.CreateString("Monster" + flatbuffers::NumToString(i));
+    monsters.push_back(CreateMonster(builder, nullptr, 150,
+                                     static_cast<int16_t>(i), name));
+  }
+  auto vec = builder.CreateVectorOfSortedTables(&monsters);
+  auto index = builder.CreateHashIndex(monsters);
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Root"), 0,
+                                             Color_Blue, Any_NONE, 0, 0, 0,
+                                             vec, 0, 0, 0, index));
+  flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                 builder.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  auto root = GetMonster(builder.GetBufferPointer());
+  TEST_EQ(root->testarrayoftables_index()->size(), 2048U);
+  for (int i = 0; i < 1000; i++) {
+    auto name = "Monster" + flatbuffers::NumToString(i);
+    auto monster = root->testarrayoftables_find(name.c_str());
+    TEST_NOTNULL(monster);
+    TEST_EQ(monster->hp(), i);
+  }
+  TEST_EQ(root->testarrayoftables_find("Monster1000") == nullptr, true);
+
+  // An index pointing outside the vector doesn't verify.
+  auto slots = const_cast<flatbuffers::Vector<uint32_t> *>(
+                 root->testarrayoftables_index());
+  auto slot = slots->Get(0);
+  slots->Mutate(0, 1001);
+  flatbuffers::Verifier bad_verifier(builder.GetBufferPointer(),
+                                     builder.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(bad_verifier), false);
+  slots->Mutate(0, slot);
+
+  // The parser creates the index if it is missing.
+  flatbuffers::Parser parser;
+  std::string schemafile;
+  TEST_EQ(flatbuffers::LoadFile("tests/monster_test.fbs", false, &schemafile),
+          true);
+  const char *include_directories[] = { "tests", nullptr };
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+  TEST_EQ(parser.Parse("{ name: \"Root\", testarrayoftables: ["
+                       "{ name: \"b\", hp: 2 }, { name: \"a\", hp: 1 }"
+                       "] }"), true);
+  root = GetMonster(parser.builder_.GetBufferPointer());
+  TEST_EQ(root->testarrayoftables_index()->size(), 4U);
+  TEST_EQ(root->testarrayoftables_find("b")->hp(), 2);
+  TEST_EQ(root->testarrayoftables_find("a")->hp(), 1);
+  TEST_EQ(root->testarrayoftables_find("c") == nullptr, true);
+}
+
+// A view reads the same fields as the table it was made from.
+void TableViewTest() {
+  auto flatbuf = CreateFlatBufferTest();
+  auto monster = GetMonster(flatbuf.c_str());
+  MonsterView view(monster);
+  TEST_EQ(view.hp(), monster->hp());
+  TEST_EQ(view.mana(), 150);  // default
+  TEST_EQ(view.color(), monster->color());
+  TEST_EQ(view.pos()->z(), monster->pos()->z());
+  TEST_EQ(view.name()->str(), monster->name()->str());
+  TEST_EQ(view.inventory(), monster->inventory());
+  TEST_EQ(view.test_type(), monster->test_type());
+  TEST_EQ(view.testarrayofstring(), monster->testarrayofstring());
+  TEST_EQ(view.enemy() == nullptr, true);  // not set
+  MonsterView enemy_view(monster->testarrayoftables()->Get(0));
+  TEST_EQ(enemy_view.hp(), 100);  // field past the end of its vtable
+  TEST_EQ(enemy_view.name()->str(), "Fred");
+}
+
+// Columns read the same values as the accessors, including defaults.
+void ExtractColumnTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < 100; i++) {
+    auto name = builder.CreateString("Monster" + flatbuffers::NumToString(i));
+    if (i % 10) {
+      monsters.push_back(CreateMonster(builder, nullptr, 150,
+                                       static_cast<int16_t>(i), name, 0,
+                                       Color_Red));
+    } else {
+      // A different vtable, with hp and color left at their defaults.
+      MonsterBuilder mb(builder);
+      mb.add_name(name);
+      monsters.push_back(mb.Finish());
+    }
+  }
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Root"), 0,
+                                             Color_Blue, Any_NONE, 0, 0, 0,
+                                             builder.CreateVector(monsters)));
+  auto tables = GetMonster(builder.GetBufferPointer())->testarrayoftables();
+  auto hp = flatbuffers::ExtractColumn<MonsterFields::hp>(tables);
+  int8_t colors[100];
+  flatbuffers::ExtractColumn<MonsterFields::color>(tables, colors);
+  TEST_EQ(hp.size(), 100U);
+  for (flatbuffers::uoffset_t i = 0; i < tables->size(); i++) {
+    TEST_EQ(hp[i], tables->Get(i)->hp());
+    TEST_EQ(colors[i], tables->Get(i)->color());
+  }
+  TEST_EQ(hp[0], 100);
+  TEST_EQ(hp[99], 99);
+}
+
+// Vector iterators work with the random access algorithms.
+void VectorIteratorTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<uint16_t> values;
+  for (uint16_t i = 0; i < 100; i++) values.push_back(i * 3);
+  builder.Finish(builder.CreateVector(values));
+  auto vec = flatbuffers::GetRoot<flatbuffers::Vector<uint16_t>>(
+               builder.GetBufferPointer());
+  typedef flatbuffers::Vector<uint16_t>::const_iterator iterator;
+  static_assert(std::is_same<std::iterator_traits<iterator>::iterator_category,
+                             std::random_access_iterator_tag>::value,
+                "VectorIterator should be random access");
+  auto begin = vec->begin(), end = vec->end();
+  TEST_EQ(end - begin, 100);
+  TEST_EQ(std::distance(begin, end), 100);
+  TEST_EQ(begin[10], 30);
+  TEST_EQ(*(begin + 10), 30);
+  TEST_EQ(*(10 + begin), 30);
+  TEST_EQ(*(end - 1), 297);
+  auto it = end;
+  it -= 2;
+  TEST_EQ(*it--, 294);
+  TEST_EQ(*it, 291);
+  TEST_EQ(*--it, 288);
+  TEST_EQ(begin < it && it <= it && end > it && end >= end, true);
+  TEST_EQ(*std::lower_bound(begin, end, 100), 102);
+  TEST_EQ(std::upper_bound(begin, end, 297) == end, true);
+  TEST_EQ(std::binary_search(begin, end, 150), true);
+  TEST_EQ(*std::reverse_iterator<iterator>(end), 297);
+
+  // Tables, sorted by name.
+  auto flatbuf = CreateFlatBufferTest();
+  auto tables = GetMonster(flatbuf.c_str())->testarrayoftables();
+  auto fred = std::lower_bound(tables->begin(), tables->end(), "Fred",
+                               [](const Monster *m, const char *name) {
+                                 return strcmp(m->name()->c_str(), name) < 0;
+                               });
+  TEST_EQ(fred->name()->str(), "Fred");
+}
+
+// Strings compare by length and bytes, and can be read without a copy.
+void StringViewTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  auto a = builder.CreateString("ab", 2);
+  auto a0 = builder.CreateString("ab\0", 3);
+  auto a0c = builder.CreateString("ab\0c", 4);
+  auto b = builder.CreateString("b", 1);
+  builder.Finish(builder.CreateVector(std::vector<flatbuffers::Offset<
+                                        flatbuffers::String>>{ a, a0, a0c,
+                                                               b }));
+  auto strings = flatbuffers::GetRoot<flatbuffers::Vector<
+                   flatbuffers::Offset<flatbuffers::String>>>(
+                   builder.GetBufferPointer());
+  auto sa = strings->Get(0), sa0 = strings->Get(1), sa0c = strings->Get(2),
+       sb = strings->Get(3);
+  TEST_EQ(*sa < *sa0 && *sa0 < *sa0c && *sa0c < *sb, true);
+  TEST_EQ(*sa0 < *sa || *sa0 == *sa0c, false);
+  TEST_EQ(*sa0 == *sa0 && *sa0 != *sa, true);
+  TEST_EQ(sa0c->str_view().size(), 4U);
+  TEST_EQ(sa0c->str_view().data(), sa0c->c_str());
+  TEST_EQ(sa0c->compare(flatbuffers::string_view("ab\0c", 4)), 0);
+  TEST_EQ(sa0c->compare("ab") > 0, true);
+  TEST_EQ(sa->compare("abc") < 0, true);
+  TEST_EQ(flatbuffers::HashString(sa0c),
+          flatbuffers::HashString(flatbuffers::string_view("ab\0c", 4)));
+  TEST_EQ(flatbuffers::HashString(sa0) != flatbuffers::HashString(sa), true);
+  // Views of absent strings have no data, but compare like empty strings.
+  flatbuffers::string_view absent;
+  TEST_EQ(absent == flatbuffers::string_view(""), true);
+  TEST_EQ(absent.compare(flatbuffers::string_view()), 0);
+  TEST_EQ(absent.compare("a") < 0, true);
+  TEST_EQ(sa->compare(absent) > 0, true);
+
+  auto flatbuf = CreateFlatBufferTest();
+  auto monster = GetMonster(flatbuf.c_str());
+  TEST_EQ(monster->name_view() == "MyMonster", true);
+  TEST_EQ(MonsterView(monster).name_view() == "MyMonster", true);
+  auto enemy = monster->testarrayoftables()->Get(0);
+  TEST_EQ(enemy->name_view().size(), 4U);
+}
+
+// Buffers can be verified and read straight from a mapped file.
+void MappedFileTest() {
+  std::string contents;
+  TEST_EQ(flatbuffers::LoadFile("tests/monsterdata_test.mon", true,
+                                &contents), true);
+  flatbuffers::MappedFile file("tests/monsterdata_test.mon",
+                               flatbuffers::MappedFile::kAccessRandom);
+  TEST_NOTNULL(file.data());
+  TEST_EQ(file.size(), contents.size());
+  TEST_EQ(memcmp(file.data(), contents.data(), contents.size()), 0);
+  TEST_EQ(reinterpret_cast<uintptr_t>(file.data()) %
+          sizeof(flatbuffers::largest_scalar_t), 0U);
+  flatbuffers::Verifier verifier(file.data(), file.size());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  TEST_EQ(GetMonster(file.data())->name()->str(), "MyMonster");
+
+  file.Close();
+  TEST_EQ(file.data() == nullptr, true);
+  TEST_EQ(file.Open("tests/does_not_exist.mon"), false);
+}
+
+// Nested buffers are verified along with the buffer they're in.
+void NestedFlatBufferTest() {
+  flatbuffers::FlatBufferBuilder nested_builder;
+  Vec3 pos(1, 2, 3, 4.5, Color_Red, Test(10, 20));
+  FinishMonsterBuffer(nested_builder, CreateMonster(nested_builder, &pos,
+                                                    150, 80,
+                                                    nested_builder.CreateString(
+                                                      "Nested")));
+  flatbuffers::FlatBufferBuilder builder;
+  auto name = builder.CreateString("Outer");
+  builder.CreateString("x");  // Leaves the size 4 but not 8 byte aligned.
+  auto nested = builder.CreateNestedFlatBuffer(
+                  nested_builder.GetBufferPointer(), nested_builder.GetSize());
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80, name,
+                                             0, Color_Blue, Any_NONE, 0, 0, 0,
+                                             0, 0, nested));
+  auto monster = GetMonster(builder.GetBufferPointer());
+  auto bytes = monster->testnestedflatbuffer();
+  TEST_EQ(reinterpret_cast<uintptr_t>(bytes->Data()) %
+          sizeof(flatbuffers::largest_scalar_t), 0U);
+  TEST_EQ(monster->testnestedflatbuffer_nested_root()->pos()->test1(), 4.5);
+  TEST_EQ(monster->testnestedflatbuffer_verified_nested_root()->name()->str(),
+          "Nested");
+  flatbuffers::Verifier verifier(builder.GetBufferPointer(),
+                                 builder.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  // The nested tables count towards the limits.
+  flatbuffers::Verifier limited_verifier(builder.GetBufferPointer(),
+                                         builder.GetSize(), 64, 1);
+  TEST_EQ(VerifyMonsterBuffer(limited_verifier), false);
+
+  // A nested root pointing outside the nested buffer, though still inside
+  // the outer one, is caught.
+  auto root_offset = const_cast<uint8_t *>(bytes->Data());
+  flatbuffers::WriteScalar<flatbuffers::uoffset_t>(root_offset,
+                                                   bytes->size() + 4);
+  flatbuffers::Verifier bad_verifier(builder.GetBufferPointer(),
+                                     builder.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(bad_verifier), false);
+  TEST_EQ(monster->testnestedflatbuffer_verified_nested_root() == nullptr,
+          true);
+}
+
+// A lazy verifier only checks what is read, and catches bad data there.
+void LazyVerifierTest() {
+  auto flatbuf = CreateFlatBufferTest();
+  auto buf = reinterpret_cast<const uint8_t *>(flatbuf.c_str());
+  {
+    flatbuffers::LazyVerifier verifier(buf, flatbuf.length());
+    MonsterLazy monster(verifier.GetRoot<Monster>(), verifier);
+    TEST_EQ(static_cast<bool>(monster), true);
+    TEST_EQ(monster.hp(), 80);
+    TEST_EQ(monster.pos()->z(), 3);
+    TEST_EQ(monster.name()->str(), "MyMonster");
+    TEST_EQ(monster.inventory()->Get(4), 4);
+    TEST_EQ(monster.testarrayofstring()->Get(1)->str(), "fred");
+    TEST_EQ(monster.testarrayoftables().size(), 1U);
+    TEST_EQ(monster.testarrayoftables().Get(0).name()->str(), "Fred");
+    TEST_EQ(static_cast<bool>(monster.enemy()), false);
+    TEST_NOTNULL(monster.test());
+    TEST_EQ(verifier.ok(), true);
+  }
+
+  // Make a string claim to be longer than the buffer.
+  auto bad = flatbuf;
+  auto bad_buf = reinterpret_cast<uint8_t *>(&bad[0]);
+  auto str = GetMonster(bad_buf)->testarrayofstring()->Get(0);
+  flatbuffers::WriteScalar<flatbuffers::uoffset_t>(
+    const_cast<flatbuffers::String *>(str), 1000000);
+  flatbuffers::Verifier full_verifier(bad_buf, bad.length());
+  TEST_EQ(VerifyMonsterBuffer(full_verifier), false);
+  flatbuffers::LazyVerifier verifier(bad_buf, bad.length());
+  MonsterLazy monster(verifier.GetRoot<Monster>(), verifier);
+  TEST_EQ(monster.name()->str(), "MyMonster");
+  TEST_EQ(verifier.ok(), true);
+  TEST_EQ(monster.testarrayofstring() == nullptr, true);
+  TEST_EQ(verifier.ok(), false);
+
+  // A root offset outside the buffer.
+  flatbuffers::LazyVerifier short_verifier(buf, 3);
+  TEST_EQ(short_verifier.GetRoot<Monster>() == nullptr, true);
+
+  // Reading the same union again doesn't count its tables again.
+  flatbuffers::LazyVerifier limited_verifier(buf, flatbuf.length(), 10);
+  MonsterLazy limited(limited_verifier.GetRoot<Monster>(), limited_verifier);
+  for (int i = 0; i < 20; i++) TEST_NOTNULL(limited.test());
+  TEST_EQ(limited_verifier.ok(), true);
+}
+
+// PresentFields() agrees with CheckField() for every field.
+void PresentFieldsTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < 64; i++) {
+    auto name = builder.CreateString("Monster");
+    uint8_t inv[] = { 1, 2 };
+    auto inventory = builder.CreateVector(inv, 2);
+    Vec3 pos(1, 2, 3, 4, Color_Red, Test(5, 6));
+    MonsterBuilder mb(builder);
+    if (i & 1) mb.add_pos(&pos);
+    if (i & 2) mb.add_hp(static_cast<int16_t>(i));
+    mb.add_name(name);  // Required.
+    if (i & 4) mb.add_mana(static_cast<int16_t>(i));
+    if (i & 8) mb.add_inventory(inventory);
+    if (i & 16) mb.add_color(Color_Green);
+    if (i & 32) mb.add_testarrayoftables_index(0);  // Last field.
+    monsters.push_back(mb.Finish());
+  }
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Root"), 0,
+                                             Color_Blue, Any_NONE, 0, 0, 0,
+                                             builder.CreateVector(monsters)));
+  auto tables = GetMonster(builder.GetBufferPointer())->testarrayoftables();
+  for (flatbuffers::uoffset_t i = 0; i < tables->size(); i++) {
+    auto monster = tables->Get(i);
+    auto table = reinterpret_cast<const flatbuffers::Table *>(monster);
+    auto present = monster->PresentFields();
+    auto wide = table->PresentFields<std::bitset<100>>();
+    for (flatbuffers::voffset_t id = 0; id < 100; id++) {
+      auto field = static_cast<flatbuffers::voffset_t>(4 + 2 * id);
+      TEST_EQ(table->CheckField(field), wide[id]);
+      if (id < 64) {
+        TEST_EQ(table->CheckField(field), ((present >> id) & 1) != 0);
+      }
+    }
+    TEST_EQ((present & Monster::Present_hp) != 0, (i & 2) != 0);
+    TEST_EQ((present & Monster::RequiredFields) == Monster::RequiredFields,
+            true);
+  }
+}
+
+// Tables in a nested buffer can't use vtables outside of it, even ones the
+// verifier already checked for the outer buffer.
+void NestedVTableTest() {
+  flatbuffers::FlatBufferBuilder nested_builder;
+  FinishMonsterBuffer(nested_builder, CreateMonster(nested_builder, nullptr,
+                                                    150, 80,
+                                                    nested_builder.CreateString(
+                                                      "Nested")));
+  flatbuffers::FlatBufferBuilder builder;
+  // A table laid out like the nested root, verified before it.
+  auto child = CreateMonster(builder, nullptr, 150, 80,
+                             builder.CreateString("Child"));
+  auto children = builder.CreateVector(&child, 1);
+  auto nested = builder.CreateNestedFlatBuffer(
+                  nested_builder.GetBufferPointer(), nested_builder.GetSize());
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Outer"),
+                                             0, Color_Blue, Any_NONE, 0, 0, 0,
+                                             children, 0, nested));
+  auto buf = builder.GetBufferPointer();
+  flatbuffers::Verifier verifier(buf, builder.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+
+  // Point the nested root at the vtable of the child, outside the nested
+  // buffer.
+  auto child_table = reinterpret_cast<const uint8_t *>(
+                       GetMonster(buf)->testarrayoftables()->Get(0));
+  auto child_vtable = child_table -
+                      flatbuffers::ReadScalar<flatbuffers::soffset_t>(
+                        child_table);
+  auto nested_buf = const_cast<uint8_t *>(
+                      GetMonster(buf)->testnestedflatbuffer()->Data());
+  auto nested_root = nested_buf +
+                     flatbuffers::ReadScalar<flatbuffers::uoffset_t>(
+                       nested_buf);
+  flatbuffers::WriteScalar<flatbuffers::soffset_t>(
+    nested_root, static_cast<flatbuffers::soffset_t>(nested_root -
+                                                     child_vtable));
+  TEST_EQ(GetMonster(nested_buf)->hp(), 80);  // Still reads the same.
+  flatbuffers::Verifier bad_verifier(buf, builder.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(bad_verifier), false);
+}
+
+// A SchemaVerifier for the schema loaded at runtime must agree with the
+// generated verifier, also for buffers with random bytes changed.
+void SchemaVerifierTest() {
+  std::string schemafile;
+  TEST_EQ(flatbuffers::LoadFile("tests/monster_test.fbs", false, &schemafile),
+          true);
+  flatbuffers::Parser parser;
+  const char *include_directories[] = { "tests", nullptr };
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+  flatbuffers::SchemaVerifier schema_verifier(parser);
+
+  // Use all kinds of fields: those of CreateFlatBufferTest() nested in a
+  // buffer with a hash index.
+  auto nested_buf = CreateFlatBufferTest();
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < 3; i++) {
+    auto name = builder.CreateString("Monster" + flatbuffers::NumToString(i));
+    monsters.push_back(CreateMonster(builder, nullptr, 150,
+                                     static_cast<int16_t>(i), name));
+  }
+  auto vec = builder.CreateVectorOfSortedTables(&monsters);
+  auto index = builder.CreateHashIndex(monsters);
+  auto nested = builder.CreateNestedFlatBuffer(
+                  reinterpret_cast<const uint8_t *>(nested_buf.c_str()),
+                  nested_buf.size());
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Root"), 0,
+                                             Color_Blue, Any_NONE, 0, 0, 0,
+                                             vec, 0, nested, 0, index));
+  auto buf = builder.GetBufferPointer();
+  auto size = builder.GetSize();
+  TEST_EQ(schema_verifier.Verify(buf, size), true);
+  TEST_EQ(schema_verifier.Verify(buf, size / 2), false);
+
+  lcg_reset();  // Keep it deterministic.
+  int num_failed = 0;
+  for (size_t i = 0; i < size; i++) {
+    auto original = buf[i];
+    for (int j = 0; j < 4; j++) {
+      buf[i] = static_cast<uint8_t>(lcg_rand());
+      flatbuffers::Verifier verifier(buf, size);
+      auto ok = VerifyMonsterBuffer(verifier);
+      TEST_EQ(schema_verifier.Verify(buf, size), ok);
+      if (!ok) num_failed++;
+    }
+    buf[i] = original;
+  }
+  TEST_EQ(num_failed > 0, true);
+
+  // Without a root type nothing verifies.
+  flatbuffers::Parser no_root_parser;
+  TEST_EQ(no_root_parser.Parse("table T { a:int; }"), true);
+  TEST_EQ(flatbuffers::SchemaVerifier(no_root_parser).Verify(buf, size),
+          false);
+
+  // A scalar ending the buffer is all there is to read of it.
+  flatbuffers::Parser scalar_parser;
+  TEST_EQ(scalar_parser.Parse("table T { a:ubyte; } root_type T; { a:5 }"),
+          true);
+  std::vector<uint8_t> exact(scalar_parser.builder_.GetBufferPointer(),
+                             scalar_parser.builder_.GetBufferPointer() +
+                             scalar_parser.builder_.GetSize());
+  TEST_EQ(exact.back(), 5);
+  TEST_EQ(flatbuffers::SchemaVerifier(scalar_parser).Verify(exact.data(),
+                                                            exact.size()),
+          true);
+
+  // The vector a hash index is for counts towards the byte limit once:
+  // 5 bytes for each name, 8 for the vector and 12 for the index.
+  flatbuffers::FlatBufferBuilder index_builder;
+  auto one = CreateMonster(index_builder, nullptr, 150, 80,
+                           index_builder.CreateString("M"));
+  auto one_vec = index_builder.CreateVector(&one, 1);
+  auto one_index = index_builder.CreateHashIndex(&one, 1);
+  FinishMonsterBuffer(index_builder,
+                      CreateMonster(index_builder, nullptr, 150, 80,
+                                    index_builder.CreateString("R"), 0,
+                                    Color_Blue, Any_NONE, 0, 0, 0, one_vec, 0,
+                                    0, 0, one_index));
+  const size_t kIndexedBytes = 30;
+  flatbuffers::Verifier index_verifier(index_builder.GetBufferPointer(),
+                                       index_builder.GetSize(), 64, 1000000,
+                                       kIndexedBytes);
+  TEST_EQ(VerifyMonsterBuffer(index_verifier), true);
+  TEST_EQ(index_verifier.GetStats().bytes, kIndexedBytes);
+  flatbuffers::Verifier index_schema_verifier(
+                          index_builder.GetBufferPointer(),
+                          index_builder.GetSize(), 64, 1000000, kIndexedBytes);
+  TEST_EQ(schema_verifier.Verify(index_schema_verifier), true);
+  TEST_EQ(index_schema_verifier.GetStats().bytes, kIndexedBytes);
+}
+
+// Verifying on multiple threads must give the same results as on one.
+void ParallelVerifierTest() {
+  const int kMonsters = 5000;
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < kMonsters; i++) {
+    auto enemy = CreateMonster(builder, nullptr, 150, 1,
+                               builder.CreateString("Enemy"));
+    monsters.push_back(CreateMonster(builder, nullptr, 150,
+                                     static_cast<int16_t>(i),
+                                     builder.CreateString("Monster"), 0,
+                                     Color_Blue, Any_NONE, 0, 0, 0, 0,
+                                     enemy));
+  }
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Root"), 0,
+                                             Color_Blue, Any_NONE, 0, 0, 0,
+                                             builder.CreateVector(monsters)));
+  auto buf = builder.GetBufferPointer();
+  auto size = builder.GetSize();
+  const size_t num_tables = 2 * kMonsters + 1;
+  flatbuffers::Verifier serial(buf, size);
+  TEST_EQ(VerifyMonsterBuffer(serial), true);
+  for (size_t threads = 1; threads <= 4; threads++) {
+    flatbuffers::Verifier verifier(buf, size, 64, num_tables);
+    verifier.UseThreads(threads, flatbuffers::RunOnThreads);
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    auto &stats = verifier.GetStats();
+    TEST_EQ(stats.tables, num_tables);
+    TEST_EQ(stats.vectors, serial.GetStats().vectors);
+    TEST_EQ(stats.strings, serial.GetStats().strings);
+    TEST_EQ(stats.bytes, serial.GetStats().bytes);
+    TEST_EQ(stats.max_depth, 3U);
+    flatbuffers::Verifier bytes_limited(buf, size, 64, num_tables,
+                                        stats.bytes - 1);
+    bytes_limited.UseThreads(threads, flatbuffers::RunOnThreads);
+    TEST_EQ(VerifyMonsterBuffer(bytes_limited), false);
+    // All tables are counted, wherever they were verified.
+    flatbuffers::Verifier limited(buf, size, 64, num_tables - 1);
+    limited.UseThreads(threads, flatbuffers::RunOnThreads);
+    TEST_EQ(VerifyMonsterBuffer(limited), false);
+    flatbuffers::Verifier shallow(buf, size, 2, num_tables);
+    shallow.UseThreads(threads, flatbuffers::RunOnThreads);
+    TEST_EQ(VerifyMonsterBuffer(shallow), false);
+  }
+
+  // A bad table in the last range, which is verified on this thread, and
+  // in the first one.
+  auto children = GetMonster(buf)->testarrayoftables();
+  flatbuffers::uoffset_t bad[] = { kMonsters - 1, 0 };
+  for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+    auto name = const_cast<flatbuffers::String *>(
+                  children->Get(bad[i])->enemy()->name());
+    auto original = flatbuffers::ReadScalar<flatbuffers::uoffset_t>(name);
+    flatbuffers::WriteScalar<flatbuffers::uoffset_t>(name, 0xFFFFFF);
+    flatbuffers::Verifier verifier(buf, size, 64, num_tables);
+    verifier.UseThreads(4, flatbuffers::RunOnThreads);
+    TEST_EQ(VerifyMonsterBuffer(verifier), false);
+    flatbuffers::WriteScalar(name, original);
+  }
+  flatbuffers::Verifier verifier(buf, size, 64, num_tables);
+  verifier.UseThreads(4, flatbuffers::RunOnThreads);
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+
+  // A few tables that each hold a large vector, which are split one after
+  // the other.
+  const int kInner = 4;
+  flatbuffers::FlatBufferBuilder nested_builder;
+  std::vector<flatbuffers::Offset<Monster>> inner;
+  for (int i = 0; i < kInner; i++) {
+    std::vector<flatbuffers::Offset<Monster>> leaves;
+    for (int j = 0; j < 2048; j++) {
+      leaves.push_back(CreateMonster(nested_builder, nullptr, 150,
+                                     static_cast<int16_t>(j),
+                                     nested_builder.CreateString("Leaf")));
+    }
+    inner.push_back(CreateMonster(nested_builder, nullptr, 150, 1,
+                                  nested_builder.CreateString("Inner"), 0,
+                                  Color_Blue, Any_NONE, 0, 0, 0,
+                                  nested_builder.CreateVector(leaves)));
+  }
+  FinishMonsterBuffer(nested_builder,
+                      CreateMonster(nested_builder, nullptr, 150, 80,
+                                    nested_builder.CreateString("Root"), 0,
+                                    Color_Blue, Any_NONE, 0, 0, 0,
+                                    nested_builder.CreateVector(inner)));
+  auto nested_buf = nested_builder.GetBufferPointer();
+  auto nested_size = nested_builder.GetSize();
+  const size_t nested_tables = 1 + kInner + kInner * 2048;
+  flatbuffers::Verifier nested(nested_buf, nested_size, 64, nested_tables);
+  nested.UseThreads(4, flatbuffers::RunOnThreads);
+  TEST_EQ(VerifyMonsterBuffer(nested), true);
+  TEST_EQ(nested.GetStats().tables, nested_tables);
+  flatbuffers::Verifier nested_limited(nested_buf, nested_size, 64,
+                                       nested_tables - 1);
+  nested_limited.UseThreads(4, flatbuffers::RunOnThreads);
+  TEST_EQ(VerifyMonsterBuffer(nested_limited), false);
+  auto leaf_name = const_cast<flatbuffers::String *>(
+                     GetMonster(nested_buf)->testarrayoftables()->Get(2)->
+                       testarrayoftables()->Get(100)->name());
+  flatbuffers::WriteScalar<flatbuffers::uoffset_t>(leaf_name, 0xFFFFFF);
+  flatbuffers::Verifier nested_bad(nested_buf, nested_size, 64,
+                                   nested_tables);
+  nested_bad.UseThreads(4, flatbuffers::RunOnThreads);
+  TEST_EQ(VerifyMonsterBuffer(nested_bad), false);
+
+  // Every job runs exactly once.
+  std::vector<int> runs(5, 0);
+  flatbuffers::RunOnThreads(runs.size(), [](void *context, size_t i) {
+    (*static_cast<std::vector<int> *>(context))[i]++;
+  }, &runs);
+  TEST_EQ(runs == std::vector<int>(5, 1), true);
+}
+
+void VerifierStatsTest() {
+  flatbuffers::FlatBufferBuilder builder;
+  unsigned char inv_data[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+  auto inventory = builder.CreateVector(inv_data, 10);
+  flatbuffers::Offset<Monster> children[] = {
+    CreateMonster(builder, nullptr, 150, 80, builder.CreateString("A")),
+    CreateMonster(builder, nullptr, 150, 80, builder.CreateString("B"))
+  };
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Root"),
+                                             inventory, Color_Blue, Any_NONE,
+                                             0, 0, 0,
+                                             builder.CreateVector(children,
+                                                                  2)));
+  auto buf = builder.GetBufferPointer();
+  auto size = builder.GetSize();
+  flatbuffers::Verifier verifier(buf, size);
+  verifier.MeasureTime(flatbuffers::NowNanoseconds);
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  auto &stats = verifier.GetStats();
+  TEST_EQ(stats.tables, 3U);
+  TEST_EQ(stats.nanoseconds > 0, true);
+  TEST_EQ(stats.vectors, 2U);
+  TEST_EQ(stats.strings, 3U);
+  // Sizes plus contents: "Root", "A", "B", inventory and children.
+  const size_t kBytes = 5 * sizeof(flatbuffers::uoffset_t) + 4 + 1 + 1 + 10 +
+                        2 * sizeof(flatbuffers::uoffset_t);
+  TEST_EQ(stats.bytes, kBytes);
+  TEST_EQ(stats.max_depth, 2U);
+
+  flatbuffers::Verifier exact(buf, size, 64, 1000000, kBytes);
+  TEST_EQ(VerifyMonsterBuffer(exact), true);
+  flatbuffers::Verifier over(buf, size, 64, 1000000, kBytes - 1);
+  TEST_EQ(VerifyMonsterBuffer(over), false);
+
+  // A small buffer that refers to the same big vector from many tables.
+  flatbuffers::FlatBufferBuilder dag_builder;
+  std::vector<uint8_t> big(1 << 20);
+  auto big_vec = dag_builder.CreateVector(big);
+  auto name = dag_builder.CreateString("Dag");
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < 1000; i++) {
+    monsters.push_back(CreateMonster(dag_builder, nullptr, 150, 80, name,
+                                     big_vec));
+  }
+  FinishMonsterBuffer(dag_builder, CreateMonster(dag_builder, nullptr, 150,
+                                                 80, name, 0, Color_Blue,
+                                                 Any_NONE, 0, 0, 0,
+                                                 dag_builder.CreateVector(
+                                                   monsters)));
+  flatbuffers::Verifier dag(dag_builder.GetBufferPointer(),
+                            dag_builder.GetSize(), 64, 1000000,
+                            16 * dag_builder.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(dag), false);
+  TEST_EQ(dag.GetStats().tables < 100, true);  // Stopped early.
+}
+
+void StringVerifierTest() {
+  struct { const char *str; bool valid; } utf8_tests[] = {
+    { "", true },
+    { "plain ASCII, longer than a word", true },
+    { "caf\xC3\xA9", true },                          // 2 bytes.
+    { "\xE2\x82\xAC and more ASCII after it", true },  // 3 bytes.
+    { "\xF0\x9F\x98\x80", true },                      // 4 bytes.
+    { "\xF4\x8F\xBF\xBF", true },                      // U+10FFFF.
+    { "\x80", false },                                 // Continuation.
+    { "\xC0\xAF", false },                             // Overlong.
+    { "\xE0\x80\xAF", false },                         // Overlong.
+    { "\xED\xA0\x80", false },                         // Surrogate.
+    { "\xF4\x90\x80\x80", false },                     // Past U+10FFFF.
+    { "12345678\xE2\x82", false },                     // Cut short.
+    { "\xFF", false },
+  };
+  for (size_t i = 0; i < sizeof(utf8_tests) / sizeof(utf8_tests[0]); i++) {
+    auto str = utf8_tests[i].str;
+    TEST_EQ(flatbuffers::IsValidUTF8(reinterpret_cast<const uint8_t *>(str),
+                                     strlen(str)),
+            utf8_tests[i].valid);
+  }
+
+  flatbuffers::FlatBufferBuilder builder;
+  flatbuffers::Offset<flatbuffers::String> strings[] = {
+    builder.CreateString("a"),
+    builder.CreateString("caf\xC3\xA9"),
+    builder.CreateString("not \xFF UTF-8"),
+  };
+  FinishMonsterBuffer(builder, CreateMonster(builder, nullptr, 150, 80,
+                                             builder.CreateString("Root"), 0,
+                                             Color_Blue, Any_NONE, 0, 0,
+                                             builder.CreateVector(strings,
+                                                                  3)));
+  auto buf = builder.GetBufferPointer();
+  auto size = builder.GetSize();
+  flatbuffers::Verifier verifier(buf, size);
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  flatbuffers::Verifier utf8_verifier(buf, size);
+  utf8_verifier.CheckUTF8(true);
+  TEST_EQ(VerifyMonsterBuffer(utf8_verifier), false);
+
+  // Break each string in turn: its terminator, then its size.
+  auto vec = GetMonster(buf)->testarrayofstring();
+  for (flatbuffers::uoffset_t i = 0; i < vec->size(); i++) {
+    auto str = const_cast<flatbuffers::String *>(vec->Get(i));
+    auto data = const_cast<uint8_t *>(str->Data());
+    auto len = str->size();
+    data[len] = 'x';
+    flatbuffers::Verifier no_terminator(buf, size);
+    TEST_EQ(VerifyMonsterBuffer(no_terminator), false);
+    data[len] = 0;
+    auto str_size = reinterpret_cast<uint8_t *>(str);
+    auto room = static_cast<flatbuffers::uoffset_t>(buf + size - str_size);
+    flatbuffers::WriteScalar<flatbuffers::uoffset_t>(str_size, room - 4);
+    flatbuffers::Verifier too_long(buf, size);
+    TEST_EQ(VerifyMonsterBuffer(too_long), false);
+    flatbuffers::WriteScalar<flatbuffers::uoffset_t>(str_size, 0xFFFFFFFF);
+    flatbuffers::Verifier huge(buf, size);
+    TEST_EQ(VerifyMonsterBuffer(huge), false);
+    flatbuffers::WriteScalar(str_size, len);
+  }
+  // An offset past the end of the buffer.
+  auto offsets = const_cast<uint8_t *>(vec->Data());
+  auto offset = flatbuffers::ReadScalar<flatbuffers::uoffset_t>(offsets);
+  flatbuffers::WriteScalar<flatbuffers::uoffset_t>(
+    offsets, static_cast<flatbuffers::uoffset_t>(buf + size - offsets));
+  flatbuffers::Verifier past_end(buf, size);
+  TEST_EQ(VerifyMonsterBuffer(past_end), false);
+  flatbuffers::WriteScalar(offsets, offset);
+  flatbuffers::Verifier restored(buf, size);
+  TEST_EQ(VerifyMonsterBuffer(restored), true);
+
+  // Many offsets to one large string count towards the byte limit each
+  // time, which is checked before each string's UTF-8.
+  flatbuffers::FlatBufferBuilder shared_builder;
+  auto big = shared_builder.CreateString(std::string(1 << 16, 'a'));
+  std::vector<flatbuffers::Offset<flatbuffers::String>> shared(1000, big);
+  FinishMonsterBuffer(shared_builder,
+                      CreateMonster(shared_builder, nullptr, 150, 80,
+                                    shared_builder.CreateString("Root"), 0,
+                                    Color_Blue, Any_NONE, 0, 0,
+                                    shared_builder.CreateVector(shared)));
+  auto shared_buf = shared_builder.GetBufferPointer();
+  auto shared_size = shared_builder.GetSize();
+  flatbuffers::Verifier unlimited(shared_buf, shared_size);
+  unlimited.CheckUTF8(true);
+  TEST_EQ(VerifyMonsterBuffer(unlimited), true);
+  TEST_EQ(unlimited.GetStats().bytes > 1000U << 16, true);
+  flatbuffers::Verifier limited(shared_buf, shared_size, 64, 1000000,
+                                1 << 20);
+  limited.CheckUTF8(true);
+  TEST_EQ(VerifyMonsterBuffer(limited), false);
+}
+
 // High level stress/fuzz test: generate a big schema and
 // matching json data in random combinations, then parse both,
 // generate json back from the binary, and compare with the original.
@@ -632,6 +1898,31 @@ int main(int /*argc*/, const char * /*argv*/[]) {
 
   FuzzTest1();
   FuzzTest2();
+  VtableDedupTest();
+  SharedStringTest();
+  ReleaseBufferTest();
+  BufferGrowthTest();
+  ChunkedBuilderTest();
+  BulkVectorTest();
+  SizeHintTest();
+  ExternalVectorTest();
+  SortFieldsTest();
+  FixedLayoutTest();
+  KeyLookupTest();
+  HashIndexTest();
+  TableViewTest();
+  ExtractColumnTest();
+  VectorIteratorTest();
+  StringViewTest();
+  MappedFileTest();
+  NestedFlatBufferTest();
+  LazyVerifierTest();
+  PresentFieldsTest();
+  NestedVTableTest();
+  SchemaVerifierTest();
+  ParallelVerifierTest();
+  VerifierStatsTest();
+  StringVerifierTest();
 
   ErrorTest();
   ScientificTest();